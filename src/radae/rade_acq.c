@@ -42,6 +42,93 @@
                            INITIALIZATION
 \*---------------------------------------------------------------------------*/
 
+/* Pilot shifted to f Hz, p[n] * exp(j*w*n) where w = 2*pi*f/Fs, split
+   into real and imaginary parts */
+static void acq_pilot_at(const rade_acq *acq, float f, float *pw_re, float *pw_im) {
+    float w = 2.0f * M_PI * f / acq->fs;
+
+    for (int n = 0; n < RADE_M; n++) {
+        RADE_COMP p_w = rade_cmul(rade_cexp(w * n), acq->p[n]);
+        pw_re[n] = p_w.real;
+        pw_im[n] = p_w.imag;
+    }
+}
+
+/* Check tdecim suits the grid, and set up the decimated FFT the FFT
+   correlator needs for it */
+static int acq_init_decim(rade_acq *acq, int tdecim) {
+    if (tdecim < 1 || acq->nmf % tdecim != 0) {
+        return -1;
+    }
+    if (acq->fft_en && tdecim > 1) {
+        if ((RADE_ACQ_NFFT / 2) % tdecim != 0) {
+            return -1;
+        }
+        if (rade_fft_init(&acq->fft_decim, RADE_ACQ_NFFT / tdecim, 0) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Search frequencies and everything derived from them */
+static int acq_set_grid(rade_acq *acq, float frange, float fstep) {
+    int L = RADE_ACQ_NFFT;
+
+    /* Set up frequency search range.  Ranges needing more than
+       RADE_ACQ_NFREQ steps are searched on a coarser grid, in multiples of
+       fstep, and peaks are then resolved to fstep */
+    int nsteps = (int)ceilf(frange / fstep - 1E-3f);
+    float fcoarse_step = fstep * ((nsteps + RADE_ACQ_NFREQ - 1) / RADE_ACQ_NFREQ);
+    if (nsteps < 1 || fcoarse_step > RADE_ACQ_FSTEP_MAX) {
+        return -1;
+    }
+    acq->fcoarse_step = fcoarse_step;
+    acq->ffine_step = fstep;
+    acq->n_fcoarse = 0;
+    for (float f = -frange / 2.0f; f < frange / 2.0f && acq->n_fcoarse < RADE_ACQ_NFREQ; f += fcoarse_step) {
+        acq->fcoarse_range[acq->n_fcoarse++] = f;
+    }
+
+    /* Pre-compute frequency-shifted pilots */
+    for (int f_idx = 0; f_idx < acq->n_fcoarse; f_idx++) {
+        acq_pilot_at(acq, acq->fcoarse_range[f_idx], acq->pw_re[f_idx], acq->pw_im[f_idx]);
+    }
+
+    /* FFT correlator set up.  A search frequency f is a circular shift of
+       f*NFFT/Fs bins of the pilot spectrum, so one table covers them all */
+    acq->fft_en = (rade_fft_init(&acq->fft, L, 0) == 0);
+    for (int f_idx = 0; f_idx < acq->n_fcoarse; f_idx++) {
+        float f = acq->fcoarse_range[f_idx];
+        int bin = (int)roundf(f * L / acq->fs);
+        if (fabsf(bin * (float)acq->fs / L - f) > 1E-3f) {
+            acq->fft_en = 0;
+        }
+        acq->fbin[f_idx] = bin;
+    }
+
+    if (acq->fft_en) {
+        RADE_COMP p_pad[RADE_ACQ_NFFT];
+        memset(p_pad, 0, sizeof(p_pad));
+        memcpy(p_pad, acq->p, sizeof(RADE_COMP) * RADE_M);
+        rade_fft(&acq->fft, acq->P_fft, p_pad);
+        for (int k = 0; k < L; k++) {
+            acq->P_fft[k] = rade_cscale(acq->P_fft[k], 1.0f / L);
+        }
+    }
+
+    /* The FFT correlator may have come on with a tdecim it can't use */
+    if (acq_init_decim(acq, acq->tdecim) != 0) {
+        acq->tdecim = 1;
+    }
+
+    /* Columns and their meaning have changed, start afresh */
+    acq->Dt2_age = -1;
+    acq->sweep_pos = 0;
+    acq->n_cand = 0;
+    return 0;
+}
+
 void rade_acq_init(rade_acq *acq, const rade_ofdm *ofdm, float frange, float fstep) {
     memset(acq, 0, sizeof(rade_acq));
 
@@ -50,6 +137,14 @@ void rade_acq_init(rade_acq *acq, const rade_ofdm *ofdm, float frange, float fst
     acq->ncp = RADE_NCP;
     acq->nmf = RADE_NMF;
 
+    acq->arch = rade_dsp_arch();
+    rade_pool_init(&acq->pool, 1);
+    acq->slide_en = 1;
+    acq->Dt2_age = -1;
+    acq->tdecim = 1;
+    acq->Dt_step = 1;
+    acq->rand_state = 1;
+
     acq->Pacq_error1 = RADE_ACQ_PACQ_ERR1;
     acq->Pacq_error2 = RADE_ACQ_PACQ_ERR2;
 
@@ -61,31 +156,410 @@ void rade_acq_init(rade_acq *acq, const rade_ofdm *ofdm, float frange, float fst
     RADE_COMP p_dot = rade_cdot(ofdm->p, ofdm->p, RADE_M);
     acq->sigma_p = sqrtf(p_dot.real);
 
-    /* Set up frequency search range */
-    acq->n_fcoarse = 0;
-    for (float f = -frange / 2.0f; f < frange / 2.0f && acq->n_fcoarse < RADE_ACQ_NFREQ; f += fstep) {
-        acq->fcoarse_range[acq->n_fcoarse++] = f;
+    int ret = acq_set_grid(acq, frange, fstep);
+    assert(ret == 0);
+    (void)ret;
+}
+
+/*---------------------------------------------------------------------------*\
+                           PILOT DETECTION
+\*---------------------------------------------------------------------------*/
+
+/* Rows of reduction work handed out at a time.  The block partition is
+   fixed, so the threshold sums come out the same for any thread count */
+#define ACQ_BLOCK_ROWS          32
+#define ACQ_NBLOCKS             ((RADE_NMF + ACQ_BLOCK_ROWS - 1) / ACQ_BLOCK_ROWS)
+
+/* One correlation pass, shared by the pool threads */
+typedef struct {
+    rade_acq *acq;
+    float (*abs_Dt)[RADE_ACQ_NFREQ];            /* Output rows, |Dt| */
+    int f_start, f_end;                         /* Search frequencies to fill */
+    const float *rx_re;                         /* Direct: split rx */
+    const float *rx_im;
+    const RADE_COMP *X;                         /* FFT: conj(FFT(rx)) */
+} acq_corr_job;
+
+/* Peak and noise statistics of one block of rows */
+typedef struct {
+    float Dtmax12;
+    int t_max;
+    int f_ind_max;
+    float sum_abs_Dt1;
+    float sum_abs_Dt2;
+    int nrows;                                  /* Rows visited */
+    rade_acq_peak peaks[RADE_ACQ_TOPK];         /* Strongest separate peaks */
+    int npeaks;
+} acq_block_stats;
+
+typedef struct {
+    rade_acq *acq;
+    int nblocks;
+    acq_block_stats stats[ACQ_NBLOCKS];
+} acq_reduce_job;
+
+/* Brute force correlation over one modem frame of timing offsets:
+   Dt[t][f] = sum(conj(rx[t:t+M]) * p_w[:][f]), t = 0..Nmf-1
+   Each thread takes a contiguous range of t */
+static void acq_corr_direct_part(void *arg, int part, int nparts) {
+    acq_corr_job *job = (acq_corr_job *)arg;
+    rade_acq *acq = job->acq;
+    int M = acq->m;
+    int Nmf = acq->nmf;
+
+    int D = acq->tdecim;
+
+    int t_start = (Nmf * part / nparts + D - 1) / D * D;
+    int t_end = Nmf * (part + 1) / nparts;
+    for (int t = t_start; t < t_end; t += D) {
+        for (int f_idx = job->f_start; f_idx < job->f_end; f_idx++) {
+            job->abs_Dt[t][f_idx] = rade_cabs(rade_cdot_split(&job->rx_re[t], &job->rx_im[t],
+                                                              acq->pw_re[f_idx], acq->pw_im[f_idx],
+                                                              M, acq->arch));
+        }
     }
+}
 
-    /* Pre-compute frequency-shifted pilots: p_w[n][f_idx] = p[n] * exp(j*w*n)
-       where w = 2*pi*f/Fs */
-    for (int f_idx = 0; f_idx < acq->n_fcoarse; f_idx++) {
-        float f = acq->fcoarse_range[f_idx];
-        float w = 2.0f * M_PI * f / acq->fs;
+/* Same rows via frequency domain cross-correlation.  With X = FFT(rx) and
+   P = FFT(p) the frequency shifted pilot p_w[:][f] has spectrum P[k - fbin],
+   so for every search frequency:
+
+     Dt[t][f] = FFT(conj(X[k]) * P[k - fbin])[t] / NFFT
+
+   The Nmf + M - 1 input samples give a correlation that is non-zero over
+   fewer than NFFT/2 lags, so two search frequencies share each transform:
+   multiplying the second by (-1)^k moves its output NFFT/2 samples along.
+   Each thread takes every nparts-th pair of search frequencies.
+
+   For a coarse to fine search only every D-th output is needed.  Folding
+   the spectrum, Z[m] = sum(Y[m + q*NFFT/D]), q = 0..D-1, aliases the output
+   so an NFFT/D point transform of Z gives y[0], y[D], y[2D], ... */
+static void acq_corr_fft_part(void *arg, int part, int nparts) {
+    acq_corr_job *job = (acq_corr_job *)arg;
+    rade_acq *acq = job->acq;
+    int Nmf = acq->nmf;
+    int L = RADE_ACQ_NFFT;
+    int D = acq->tdecim;
+    int Ld = L / D;
 
-        for (int n = 0; n < RADE_M; n++) {
-            RADE_COMP w_vec = rade_cexp(w * n);
-            acq->p_w[n][f_idx] = rade_cmul(w_vec, acq->p[n]);
+    RADE_COMP buf[RADE_ACQ_NFFT];
+    RADE_COMP Y[RADE_ACQ_NFFT];
+
+    for (int f_idx = job->f_start + 2 * part; f_idx < job->f_end; f_idx += 2 * nparts) {
+        int pair = (f_idx + 1 < job->f_end);
+        int bin_a = acq->fbin[f_idx];
+        int bin_b = pair ? acq->fbin[f_idx + 1] : 0;
+
+        for (int k = 0; k < L; k++) {
+            int ja = k - bin_a;
+            if (ja < 0) ja += L;
+            if (ja >= L) ja -= L;
+            RADE_COMP Pk = acq->P_fft[ja];
+
+            if (pair) {
+                int jb = k - bin_b;
+                if (jb < 0) jb += L;
+                if (jb >= L) jb -= L;
+                Pk = (k & 1) ? rade_csub(Pk, acq->P_fft[jb]) : rade_cadd(Pk, acq->P_fft[jb]);
+            }
+            Y[k] = rade_cmul(job->X[k], Pk);
+        }
+
+        if (D == 1) {
+            rade_fft(&acq->fft, buf, Y);
+        } else {
+            for (int q = 1; q < D; q++) {
+                for (int m = 0; m < Ld; m++) {
+                    Y[m] = rade_cadd(Y[m], Y[q * Ld + m]);
+                }
+            }
+            rade_fft(&acq->fft_decim, buf, Y);
+        }
+
+        for (int t = 0; t < Nmf; t += D) {
+            job->abs_Dt[t][f_idx] = rade_cabs(buf[t / D]);
+            if (pair) {
+                job->abs_Dt[t][f_idx + 1] = rade_cabs(buf[(L / 2 + t) / D]);
+            }
         }
     }
 }
 
-/*---------------------------------------------------------------------------*\
-                           PILOT DETECTION
-\*---------------------------------------------------------------------------*/
+/* Correlation magnitude rows |Dt[0..Nmf)| against rx[0 .. Nmf+M-1), for
+   search frequencies f_start .. f_end-1 */
+static void acq_corr_rows(rade_acq *acq, float abs_Dt[][RADE_ACQ_NFREQ], const RADE_COMP *rx,
+                          int f_start, int f_end) {
+    int M = acq->m;
+    int Nmf = acq->nmf;
+    int n_rx = Nmf + M - 1;
 
-int rade_acq_detect_pilots(rade_acq *acq, const RADE_COMP *rx, int *tmax, float *fmax) {
+    acq_corr_job job;
+    job.acq = acq;
+    job.abs_Dt = abs_Dt;
+    job.f_start = f_start;
+    job.f_end = f_end;
+
+    if (acq->fft_en) {
+        int L = RADE_ACQ_NFFT;
+        assert(n_rx + M - 1 <= L / 2);
+
+        RADE_COMP buf[RADE_ACQ_NFFT];
+        RADE_COMP X[RADE_ACQ_NFFT];
+        memcpy(buf, rx, sizeof(RADE_COMP) * n_rx);
+        memset(&buf[n_rx], 0, sizeof(RADE_COMP) * (L - n_rx));
+        rade_fft(&acq->fft, X, buf);
+        for (int k = 0; k < L; k++) {
+            X[k] = rade_cconj(X[k]);
+        }
+
+        job.X = X;
+        rade_pool_run(&acq->pool, acq_corr_fft_part, &job);
+    } else {
+        float rx_re[RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+        float rx_im[RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+        rade_csplit(rx_re, rx_im, rx, n_rx);
+
+        job.rx_re = rx_re;
+        job.rx_im = rx_im;
+        rade_pool_run(&acq->pool, acq_corr_direct_part, &job);
+    }
+}
+
+/* Linear congruential generator (Numerical Recipes constants), returning
+   the better mixed top 16 bits */
+static unsigned int acq_rand(unsigned int *state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 16;
+}
+
+/* Add pk to peaks[0..*npeaks), kept strongest first and at most
+   RADE_ACQ_TOPK long.  Peaks within dt samples of a stronger one are
+   dropped, so the list holds separate peaks rather than the neighbours of
+   the biggest one.  The pilot correlation is about Fs/M wide in frequency,
+   so neighbours are judged on timing alone */
+static void acq_peak_insert(rade_acq_peak *peaks, int *npeaks, rade_acq_peak pk, int dt) {
+    if (*npeaks == RADE_ACQ_TOPK && pk.Dt12 <= peaks[RADE_ACQ_TOPK - 1].Dt12) {
+        return;
+    }
+
+    for (int i = 0; i < *npeaks; i++) {
+        if (abs(peaks[i].t - pk.t) <= dt) {
+            if (pk.Dt12 <= peaks[i].Dt12) {
+                return;
+            }
+            memmove(&peaks[i], &peaks[i + 1], sizeof(rade_acq_peak) * (*npeaks - i - 1));
+            (*npeaks)--;
+            i--;
+        }
+    }
+
+    int pos = *npeaks;
+    while (pos > 0 && pk.Dt12 > peaks[pos - 1].Dt12) {
+        pos--;
+    }
+    if (pos == RADE_ACQ_TOPK) {
+        return;
+    }
+    int nmove = (*npeaks < RADE_ACQ_TOPK) ? *npeaks - pos : RADE_ACQ_TOPK - 1 - pos;
+    memmove(&peaks[pos + 1], &peaks[pos], sizeof(rade_acq_peak) * nmove);
+    peaks[pos] = pk;
+    if (*npeaks < RADE_ACQ_TOPK) {
+        (*npeaks)++;
+    }
+}
+
+/* Peaks closer than this in time are taken as the same signal: a cyclic
+   prefix covers the spread of a multipath channel, and the coarse to fine
+   search needs at least the decimation */
+static int acq_peak_dt(const rade_acq *acq) {
+    return (acq->tdecim > acq->ncp) ? acq->tdecim : acq->ncp;
+}
+
+/* Peak of |Dt1| + |Dt2|, the strongest separate peaks and the |Dt| sums
+   over each block of rows.  Rows are scanned t major with a strict > so
+   the first peak wins, like a single scan of the whole grid would */
+static void acq_reduce_part(void *arg, int part, int nparts) {
+    acq_reduce_job *job = (acq_reduce_job *)arg;
+    rade_acq *acq = job->acq;
+    int Nmf = acq->nmf;
+    int D = acq->tdecim;
+    int dt = acq_peak_dt(acq);
+
+    for (int b = part; b < job->nblocks; b += nparts) {
+        acq_block_stats *st = &job->stats[b];
+        st->Dtmax12 = 0.0f;
+        st->t_max = 0;
+        st->f_ind_max = 0;
+        st->sum_abs_Dt1 = 0.0f;
+        st->sum_abs_Dt2 = 0.0f;
+        st->nrows = 0;
+        st->npeaks = 0;
+        float peak_floor = -1.0f;
+
+        int t_start = (b * ACQ_BLOCK_ROWS + D - 1) / D * D;
+        int t_end = (b + 1) * ACQ_BLOCK_ROWS;
+        if (t_end > Nmf) {
+            t_end = Nmf;
+        }
+        for (int t = t_start; t < t_end; t += D) {
+            for (int f_idx = 0; f_idx < acq->n_fcoarse; f_idx++) {
+                float abs_Dt1 = acq->abs_Dt1[t][f_idx];
+                float abs_Dt2 = acq->abs_Dt2[t][f_idx];
+
+                /* Combined metric: |Dt1| + |Dt2| */
+                float Dt12 = abs_Dt1 + abs_Dt2;
+
+                if (Dt12 > st->Dtmax12) {
+                    st->Dtmax12 = Dt12;
+                    st->f_ind_max = f_idx;
+                    st->t_max = t;
+                }
+                /* Most points are weaker than every peak kept */
+                if (Dt12 > peak_floor) {
+                    rade_acq_peak pk = { Dt12, t, f_idx, acq->fcoarse_range[f_idx] };
+                    acq_peak_insert(st->peaks, &st->npeaks, pk, dt);
+                    peak_floor = (st->npeaks == RADE_ACQ_TOPK) ?
+                                 st->peaks[RADE_ACQ_TOPK - 1].Dt12 : -1.0f;
+                }
+
+                st->sum_abs_Dt1 += abs_Dt1;
+                st->sum_abs_Dt2 += abs_Dt2;
+            }
+            st->nrows++;
+        }
+    }
+}
+
+/* Frequency of the best |Dt1| + |Dt2| at timing t within half a column of
+   search frequency f_idx, to ffine_step.  Only a wide search has anything
+   to find between its columns */
+static float acq_fine_freq(const rade_acq *acq, const RADE_COMP *rx, int t, int f_idx) {
+    int M = acq->m;
+    int Nmf = acq->nmf;
+    float f_best = acq->fcoarse_range[f_idx];
+
+    if (acq->fcoarse_step <= acq->ffine_step) {
+        return f_best;
+    }
+
+    float rx1_re[RADE_M] RADE_SIMD_ALIGN;
+    float rx1_im[RADE_M] RADE_SIMD_ALIGN;
+    float rx2_re[RADE_M] RADE_SIMD_ALIGN;
+    float rx2_im[RADE_M] RADE_SIMD_ALIGN;
+    rade_csplit(rx1_re, rx1_im, &rx[t], M);
+    rade_csplit(rx2_re, rx2_im, &rx[t + Nmf], M);
+
+    int nhalf = (int)(acq->fcoarse_step / acq->ffine_step + 0.5f) / 2;
+    float Dtmax12 = 0.0f;
+    for (int i = -nhalf; i <= nhalf; i++) {
+        float f = acq->fcoarse_range[f_idx] + i * acq->ffine_step;
+        float pw_re[RADE_M] RADE_SIMD_ALIGN;
+        float pw_im[RADE_M] RADE_SIMD_ALIGN;
+        acq_pilot_at(acq, f, pw_re, pw_im);
+
+        RADE_COMP Dt1 = rade_cdot_split(rx1_re, rx1_im, pw_re, pw_im, M, acq->arch);
+        RADE_COMP Dt2 = rade_cdot_split(rx2_re, rx2_im, pw_re, pw_im, M, acq->arch);
+        float Dt12 = rade_cabs(Dt1) + rade_cabs(Dt2);
+        if (Dt12 > Dtmax12) {
+            Dtmax12 = Dt12;
+            f_best = f;
+        }
+    }
+
+    return f_best;
+}
+
+/* Full resolution |Dt1| + |Dt2| around each coarse peak: every timing
+   offset less than tdecim away, at the peak's and neighbouring search
+   frequencies.  Each peak moves to the best point found near it */
+static void acq_refine_peaks(rade_acq *acq, const RADE_COMP *rx,
+                             rade_acq_peak *peaks, int npeaks) {
     int M = acq->m;
+    int Nmf = acq->nmf;
+    int D = acq->tdecim;
+
+    float rx_re[2 * RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    float rx_im[2 * RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    rade_csplit(rx_re, rx_im, rx, 2 * Nmf + M - 1);
+
+    for (int i = 0; i < npeaks; i++) {
+        rade_acq_peak best = { 0.0f, 0, 0, 0.0f };
+        int f_start = (peaks[i].f_idx > 0) ? peaks[i].f_idx - 1 : 0;
+        int f_end = (peaks[i].f_idx + 1 < acq->n_fcoarse) ? peaks[i].f_idx + 1 : acq->n_fcoarse - 1;
+        int t_start = (peaks[i].t - D + 1 > 0) ? peaks[i].t - D + 1 : 0;
+        int t_end = (peaks[i].t + D - 1 < Nmf - 1) ? peaks[i].t + D - 1 : Nmf - 1;
+
+        for (int f_idx = f_start; f_idx <= f_end; f_idx++) {
+            for (int t = t_start; t <= t_end; t++) {
+                RADE_COMP Dt1 = rade_cdot_split(&rx_re[t], &rx_im[t],
+                                                acq->pw_re[f_idx], acq->pw_im[f_idx], M, acq->arch);
+                RADE_COMP Dt2 = rade_cdot_split(&rx_re[t + Nmf], &rx_im[t + Nmf],
+                                                acq->pw_re[f_idx], acq->pw_im[f_idx], M, acq->arch);
+                float Dt12 = rade_cabs(Dt1) + rade_cabs(Dt2);
+
+                if (Dt12 > best.Dt12) {
+                    best.Dt12 = Dt12;
+                    best.t = t;
+                    best.f_idx = f_idx;
+                }
+            }
+        }
+        best.f = acq->fcoarse_range[best.f_idx];
+        peaks[i] = best;
+    }
+}
+
+int rade_acq_set_frange(rade_acq *acq, float frange) {
+    return acq_set_grid(acq, frange, acq->ffine_step);
+}
+
+int rade_acq_set_decim(rade_acq *acq, int tdecim) {
+    if (acq_init_decim(acq, tdecim) != 0) {
+        return -1;
+    }
+
+    acq->tdecim = tdecim;
+    acq->Dt2_age = -1;
+    acq->sweep_pos = 0;
+    return 0;
+}
+
+int rade_acq_set_budget(rade_acq *acq, int nfreq) {
+    if (nfreq < 0 || nfreq > RADE_ACQ_NFREQ) {
+        return -1;
+    }
+
+    acq->budget = nfreq;
+    acq->Dt2_age = -1;
+    acq->sweep_pos = 0;
+    return 0;
+}
+
+int rade_acq_set_threads(rade_acq *acq, int nthreads) {
+    rade_pool_close(&acq->pool);
+    return rade_pool_init(&acq->pool, nthreads);
+}
+
+void rade_acq_close(rade_acq *acq) {
+    rade_pool_close(&acq->pool);
+    rade_fft_close(&acq->fft);
+    rade_fft_close(&acq->fft_decim);
+}
+
+void rade_acq_reset(rade_acq *acq) {
+    acq->Dt2_age = -1;
+    acq->sweep_pos = 0;
+    acq->sweep_shift = 0;
+}
+
+void rade_acq_shift(rade_acq *acq, int n) {
+    if (acq->Dt2_age >= 0) {
+        acq->Dt2_age += n;
+    }
+    acq->sweep_shift += n;
+}
+
+int rade_acq_detect_pilots(rade_acq *acq, const RADE_COMP *rx, int *tmax, float *fmax) {
     int Nmf = acq->nmf;
     int n_fcoarse = acq->n_fcoarse;
 
@@ -97,52 +571,89 @@ int rade_acq_detect_pilots(rade_acq *acq, const RADE_COMP *rx, int *tmax, float
     int t_max = 0;
     float f_max = 0.0f;
 
-    /* Clear correlation grids */
-    memset(acq->Dt1, 0, sizeof(acq->Dt1));
-    memset(acq->Dt2, 0, sizeof(acq->Dt2));
-
-    /* Search over time and frequency */
-    for (int t = 0; t < Nmf; t++) {
-        for (int f_idx = 0; f_idx < n_fcoarse; f_idx++) {
-            /* Correlate with frequency-shifted pilot at time t
-               Dt1 = sum(conj(rx[t:t+M]) * p_w[:][f_idx]) */
-            RADE_COMP Dt1 = rade_czero();
-            RADE_COMP Dt2 = rade_czero();
-
-            for (int n = 0; n < M; n++) {
-                /* Note: Python uses np.conj(rx) first, then matmul
-                   So Dt1[t] = conj(rx[t:t+M]) . p_w */
-                Dt1 = rade_cadd(Dt1, rade_cmul(rade_cconj(rx[t + n]), acq->p_w[n][f_idx]));
-                Dt2 = rade_cadd(Dt2, rade_cmul(rade_cconj(rx[t + Nmf + n]), acq->p_w[n][f_idx]));
-            }
-
-            acq->Dt1[t][f_idx] = Dt1;
-            acq->Dt2[t][f_idx] = Dt2;
-
-            /* Combined metric: |Dt1| + |Dt2| */
-            float Dt12 = rade_cabs(Dt1) + rade_cabs(Dt2);
+    if (acq->budget > 0 && acq->budget < n_fcoarse) {
+        /* Budgeted search: fill in the next few search frequencies.  The
+           pilots repeat every Nmf samples, so columns computed on earlier
+           calls still line up as long as rx moved on by whole frames */
+        if (acq->sweep_shift % Nmf != 0) {
+            acq->sweep_pos = 0;
+        }
+        int f_start = acq->sweep_pos;
+        int f_end = (f_start + acq->budget < n_fcoarse) ? f_start + acq->budget : n_fcoarse;
+        acq_corr_rows(acq, acq->abs_Dt1, rx, f_start, f_end);
+        acq_corr_rows(acq, acq->abs_Dt2, &rx[Nmf], f_start, f_end);
+        acq->sweep_pos = (f_end < n_fcoarse) ? f_end : 0;
+        acq->sweep_shift = 0;
+        acq->Dt2_age = -1;
 
-            if (Dt12 > Dtmax12) {
-                Dtmax12 = Dt12;
-                f_ind_max = f_idx;
-                f_max = acq->fcoarse_range[f_idx];
-                t_max = t;
-            }
+        /* Nothing to report until the grid is complete, and the
+           candidates of the last complete grid may be long gone */
+        if (f_end < n_fcoarse) {
+            acq->complete = 0;
+            acq->n_cand = 0;
+            return 0;
+        }
+    } else {
+        /* Correlate over time and frequency.  If rx has slid along exactly
+           one modem frame since the last search, the last Dt2 is our Dt1 */
+        if (acq->slide_en && acq->Dt2_age == Nmf) {
+            memcpy(acq->abs_Dt1, acq->abs_Dt2, sizeof(acq->abs_Dt1));
+        } else {
+            acq_corr_rows(acq, acq->abs_Dt1, rx, 0, n_fcoarse);
         }
+        acq_corr_rows(acq, acq->abs_Dt2, &rx[Nmf], 0, n_fcoarse);
+        acq->Dt2_age = 0;
     }
 
-    /* Calculate threshold based on noise statistics
+    /* Find the peak, and accumulate noise statistics for the threshold
        Ref: radae.pdf "Pilot Detection over Multiple Frames" */
+    acq_reduce_job job;
+    job.acq = acq;
+    job.nblocks = (Nmf + ACQ_BLOCK_ROWS - 1) / ACQ_BLOCK_ROWS;
+    rade_pool_run(&acq->pool, acq_reduce_part, &job);
+
+    /* Combine blocks in time order */
     float sum_abs_Dt1 = 0.0f;
     float sum_abs_Dt2 = 0.0f;
     int count = 0;
+    rade_acq_peak peaks[RADE_ACQ_TOPK];
+    int npeaks = 0;
 
-    for (int t = 0; t < Nmf; t++) {
-        for (int f_idx = 0; f_idx < n_fcoarse; f_idx++) {
-            sum_abs_Dt1 += rade_cabs(acq->Dt1[t][f_idx]);
-            sum_abs_Dt2 += rade_cabs(acq->Dt2[t][f_idx]);
-            count++;
+    for (int b = 0; b < job.nblocks; b++) {
+        if (job.stats[b].Dtmax12 > Dtmax12) {
+            Dtmax12 = job.stats[b].Dtmax12;
+            f_ind_max = job.stats[b].f_ind_max;
+            f_max = acq->fcoarse_range[f_ind_max];
+            t_max = job.stats[b].t_max;
         }
+        for (int i = 0; i < job.stats[b].npeaks; i++) {
+            acq_peak_insert(peaks, &npeaks, job.stats[b].peaks[i], acq_peak_dt(acq));
+        }
+        sum_abs_Dt1 += job.stats[b].sum_abs_Dt1;
+        sum_abs_Dt2 += job.stats[b].sum_abs_Dt2;
+        count += job.stats[b].nrows * n_fcoarse;
+    }
+    acq->complete = 1;
+    acq->Dt_step = acq->tdecim;
+    acq->sum_abs_Dt1 = sum_abs_Dt1;
+    acq->sum_abs_Dt2 = sum_abs_Dt2;
+    acq->sum_count = count;
+
+    /* The decimated grid can straddle a correlation peak, so look again
+       around the best few at full resolution */
+    if (acq->tdecim > 1) {
+        rade_acq_peak coarse[RADE_ACQ_TOPK];
+        int ncoarse = npeaks;
+        memcpy(coarse, peaks, sizeof(rade_acq_peak) * npeaks);
+        acq_refine_peaks(acq, rx, coarse, ncoarse);
+        npeaks = 0;
+        for (int i = 0; i < ncoarse; i++) {
+            acq_peak_insert(peaks, &npeaks, coarse[i], acq_peak_dt(acq));
+        }
+        Dtmax12 = peaks[0].Dt12;
+        f_ind_max = peaks[0].f_idx;
+        f_max = acq->fcoarse_range[f_ind_max];
+        t_max = peaks[0].t;
     }
 
     float sigma_r1 = (sum_abs_Dt1 / count) / sqrtf(M_PI / 2.0f);
@@ -154,12 +665,229 @@ int rade_acq_detect_pilots(rade_acq *acq, const RADE_COMP *rx, int *tmax, float
     acq->Dtmax12 = Dtmax12;
     acq->f_ind_max = f_ind_max;
 
+    /* Other peaks over the threshold are worth following too, in case the
+       strongest is noise.  Much weaker ones are more likely sidelobes of a
+       strong signal than a second signal.  peaks[0] is the peak found above */
+    float cand_thresh = RADE_ACQ_CAND_RATIO * Dtmax12;
+    if (cand_thresh < acq->Dthresh) {
+        cand_thresh = acq->Dthresh;
+    }
+    acq->n_cand = 0;
+    for (int i = 0; i < npeaks && peaks[i].Dt12 > cand_thresh; i++) {
+        acq->cand[acq->n_cand] = peaks[i];
+        acq->cand[acq->n_cand].f = acq_fine_freq(acq, rx, peaks[i].t, peaks[i].f_idx);
+        acq->n_cand++;
+    }
+    if (acq->n_cand > 0) {
+        f_max = acq->cand[0].f;
+    }
+
     *tmax = t_max;
     *fmax = f_max;
 
     return (Dtmax12 > acq->Dthresh) ? 1 : 0;
 }
 
+/* Update 5% of the correlation grid against rx[0 .. 2*Nmf+M-1), split in
+   rx_re/rx_im, and return the noise sigma from the running |Dt| sums.  The
+   grid is then a mix of frames, so not reusable by the next search.
+   sigma_new: if not NULL, the noise sigma of just the updated rows
+   store: 0 to only measure the rows, leaving the grid and its sums to a
+   budgeted search part way through filling them */
+static float acq_update_noise(rade_acq *acq, const float *rx_re, const float *rx_im,
+                              float *sigma_new, int store) {
+    int M = acq->m;
+    int Nmf = acq->nmf;
+
+    if (store) {
+        acq->Dt2_age = -1;
+    }
+    int Nupdate = (int)(0.05f * Nmf);
+    int step = acq->Dt_step;
+    float sum_abs_new = 0.0f;
+    for (int i = 0; i < Nupdate; i++) {
+        int t = (acq_rand(&acq->rand_state) % (Nmf / step)) * step;
+
+        /* Swap the row's old magnitudes out of the noise sums and the new
+           ones in, rather than summing the whole grid again */
+        for (int f_idx = 0; f_idx < acq->n_fcoarse; f_idx++) {
+            float abs_Dt1 = rade_cabs(rade_cdot_split(&rx_re[t], &rx_im[t],
+                                                      acq->pw_re[f_idx], acq->pw_im[f_idx], M, acq->arch));
+            float abs_Dt2 = rade_cabs(rade_cdot_split(&rx_re[t + Nmf], &rx_im[t + Nmf],
+                                                      acq->pw_re[f_idx], acq->pw_im[f_idx], M, acq->arch));
+            if (store) {
+                acq->sum_abs_Dt1 += abs_Dt1 - acq->abs_Dt1[t][f_idx];
+                acq->sum_abs_Dt2 += abs_Dt2 - acq->abs_Dt2[t][f_idx];
+                acq->abs_Dt1[t][f_idx] = abs_Dt1;
+                acq->abs_Dt2[t][f_idx] = abs_Dt2;
+            }
+            sum_abs_new += abs_Dt1 + abs_Dt2;
+        }
+    }
+    if (sigma_new) {
+        *sigma_new = (sum_abs_new / (2 * Nupdate * acq->n_fcoarse)) / sqrtf(M_PI / 2.0f);
+    }
+
+    float sigma_r1 = 0.0f;
+    float sigma_r2 = 0.0f;
+    if (acq->sum_count > 0) {
+        sigma_r1 = (float)(acq->sum_abs_Dt1 / acq->sum_count) / sqrtf(M_PI / 2.0f);
+        sigma_r2 = (float)(acq->sum_abs_Dt2 / acq->sum_count) / sqrtf(M_PI / 2.0f);
+    }
+    return (sigma_r1 + sigma_r2) / 2.0f;
+}
+
+/* Search the window of timing offsets within trange of tcentre and
+   RADE_ACQ_VERIFY_NFREQ search frequencies either side of fcentre, with the
+   same metric and scan order as the full search.  In a wide search the
+   window steps by ffine_step, as its grid columns are too far apart to
+   tell a candidate from its neighbours.  Returns the best point, Dt12 = 0
+   if the window is empty */
+static rade_acq_peak acq_verify_window(const rade_acq *acq, const float *rx_re, const float *rx_im,
+                                       int tcentre, int trange, float fcentre) {
+    int M = acq->m;
+    int Nmf = acq->nmf;
+
+    /* Nearest search frequency to fcentre */
+    int f_centre = 0;
+    for (int f_idx = 1; f_idx < acq->n_fcoarse; f_idx++) {
+        if (fabsf(acq->fcoarse_range[f_idx] - fcentre) <
+            fabsf(acq->fcoarse_range[f_centre] - fcentre)) {
+            f_centre = f_idx;
+        }
+    }
+
+    int t_start = (tcentre - trange > 0) ? tcentre - trange : 0;
+    int t_end = (tcentre + trange < Nmf - 1) ? tcentre + trange : Nmf - 1;
+
+    /* Pilots at each frequency of the window */
+    const float *pw_re[2 * RADE_ACQ_VERIFY_NFREQ + 1];
+    const float *pw_im[2 * RADE_ACQ_VERIFY_NFREQ + 1];
+    float fw[2 * RADE_ACQ_VERIFY_NFREQ + 1];
+    int nf = 0;
+    float pw_fine_re[2 * RADE_ACQ_VERIFY_NFREQ + 1][RADE_M] RADE_SIMD_ALIGN;
+    float pw_fine_im[2 * RADE_ACQ_VERIFY_NFREQ + 1][RADE_M] RADE_SIMD_ALIGN;
+    if (acq->fcoarse_step > acq->ffine_step) {
+        float f0 = roundf(fcentre / acq->ffine_step) * acq->ffine_step;
+        for (int i = -RADE_ACQ_VERIFY_NFREQ; i <= RADE_ACQ_VERIFY_NFREQ; i++) {
+            fw[nf] = f0 + i * acq->ffine_step;
+            acq_pilot_at(acq, fw[nf], pw_fine_re[nf], pw_fine_im[nf]);
+            pw_re[nf] = pw_fine_re[nf];
+            pw_im[nf] = pw_fine_im[nf];
+            nf++;
+        }
+    } else {
+        for (int f_idx = f_centre - RADE_ACQ_VERIFY_NFREQ; f_idx <= f_centre + RADE_ACQ_VERIFY_NFREQ; f_idx++) {
+            if (f_idx >= 0 && f_idx < acq->n_fcoarse) {
+                fw[nf] = acq->fcoarse_range[f_idx];
+                pw_re[nf] = acq->pw_re[f_idx];
+                pw_im[nf] = acq->pw_im[f_idx];
+                nf++;
+            }
+        }
+    }
+
+    rade_acq_peak best = { 0.0f, tcentre, f_centre, acq->fcoarse_range[f_centre] };
+    for (int t = t_start; t <= t_end; t++) {
+        for (int i = 0; i < nf; i++) {
+            RADE_COMP Dt1 = rade_cdot_split(&rx_re[t], &rx_im[t], pw_re[i], pw_im[i], M, acq->arch);
+            RADE_COMP Dt2 = rade_cdot_split(&rx_re[t + Nmf], &rx_im[t + Nmf], pw_re[i], pw_im[i], M, acq->arch);
+            float Dt12 = rade_cabs(Dt1) + rade_cabs(Dt2);
+
+            if (Dt12 > best.Dt12) {
+                best.Dt12 = Dt12;
+                best.t = t;
+                best.f = fw[i];
+            }
+        }
+    }
+
+    /* Nearest search frequency to the result */
+    for (int f_idx = 0; f_idx < acq->n_fcoarse; f_idx++) {
+        if (fabsf(acq->fcoarse_range[f_idx] - best.f) <
+            fabsf(acq->fcoarse_range[best.f_idx] - best.f)) {
+            best.f_idx = f_idx;
+        }
+    }
+
+    return best;
+}
+
+int rade_acq_verify_candidates(rade_acq *acq, const RADE_COMP *rx, int n,
+                               const int *tcentre, const float *fcentre, int trange,
+                               int *tmax, float *fmax, int *valid) {
+    int M = acq->m;
+    int Nmf = acq->nmf;
+
+    assert(n >= 1 && n <= RADE_ACQ_TOPK);
+
+    int any_window = 0;
+    for (int i = 0; i < n; i++) {
+        valid[i] = 0;
+        tmax[i] = tcentre[i];
+        fmax[i] = fcentre[i];
+        if (tcentre[i] + trange >= 0 && tcentre[i] - trange <= Nmf - 1) {
+            any_window = 1;
+        }
+    }
+    if (!any_window) {
+        return 0;
+    }
+
+    float rx_re[2 * RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    float rx_im[2 * RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    rade_csplit(rx_re, rx_im, rx, 2 * Nmf + M - 1);
+
+    /* Most of the grid is from the last full search, which may be a few
+       frames old (or have seen the empty rx buffer at start up), so take
+       the noise level from the rows updated this frame.  A budgeted search
+       part way through the grid owns it, so then only measure them */
+    float sigma_r;
+    int sweeping = acq->sweep_pos > 0;
+    float sigma_grid = acq_update_noise(acq, rx_re, rx_im, &sigma_r, !sweeping);
+
+    /* Scale the rest of the grid to match, so rade_acq_check_pilots()
+       starts from the current noise level once we are in sync */
+    if (sigma_grid > 0.0f && !sweeping) {
+        float scale = sigma_r / sigma_grid;
+        for (int t = 0; t < Nmf; t += acq->Dt_step) {
+            for (int f_idx = 0; f_idx < acq->n_fcoarse; f_idx++) {
+                acq->abs_Dt1[t][f_idx] *= scale;
+                acq->abs_Dt2[t][f_idx] *= scale;
+            }
+        }
+        acq->sum_abs_Dt1 *= scale;
+        acq->sum_abs_Dt2 *= scale;
+    }
+    acq->Dthresh = 2.0f * sigma_r * sqrtf(-logf(acq->Pacq_error1 / 5.0f));
+
+    /* The noise level is shared, only the windows are searched per
+       candidate.  Report the strongest */
+    int nvalid = 0;
+    acq->Dtmax12 = -1.0f;
+    for (int i = 0; i < n; i++) {
+        rade_acq_peak pk = acq_verify_window(acq, rx_re, rx_im, tcentre[i], trange, fcentre[i]);
+        if (pk.Dt12 > acq->Dtmax12) {
+            acq->Dtmax12 = pk.Dt12;
+            acq->f_ind_max = pk.f_idx;
+        }
+
+        tmax[i] = pk.t;
+        fmax[i] = pk.f;
+        valid[i] = (pk.Dt12 > acq->Dthresh) ? 1 : 0;
+        nvalid += valid[i];
+    }
+
+    return nvalid;
+}
+
+int rade_acq_verify_pilots(rade_acq *acq, const RADE_COMP *rx, int tcentre, int trange,
+                           float fcentre, int *tmax, float *fmax) {
+    int valid;
+    rade_acq_verify_candidates(acq, rx, 1, &tcentre, &fcentre, trange, tmax, fmax, &valid);
+    return valid;
+}
+
 void rade_acq_refine(rade_acq *acq, const RADE_COMP *rx,
                      int *tmax, float *fmax,
                      int tfine_range_start, int tfine_range_end,
@@ -171,31 +899,47 @@ void rade_acq_refine(rade_acq *acq, const RADE_COMP *rx,
     int t_best = *tmax;
     float f_best = *fmax;
 
+    /* Split the two stretches of rx we correlate against */
+    int nt = tfine_range_end - tfine_range_start;
+    if (nt <= 0) {
+        return;
+    }
+    assert(nt <= RADE_NMF);
+    float rx1_re[RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    float rx1_im[RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    float rx2_re[RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    float rx2_im[RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    rade_csplit(rx1_re, rx1_im, &rx[tfine_range_start], nt + M - 1);
+    rade_csplit(rx2_re, rx2_im, &rx[tfine_range_start + Nmf], nt + M - 1);
+
     /* Fine search over time and frequency */
     for (float f = ffine_range_start; f < ffine_range_end; f += ffine_step) {
         float w = 2.0f * M_PI * f / acq->fs;
 
-        /* Pre-compute frequency shift vectors */
-        RADE_COMP w_vec1_p[RADE_M];
-        RADE_COMP w_vec2_p[RADE_M];
+        /* Pre-compute frequency shift vectors, conjugated so the
+           correlation sum(rx * w_vec_p) is a conj(a) * b dot product */
+        float w_vec1_p_re[RADE_M] RADE_SIMD_ALIGN;
+        float w_vec1_p_im[RADE_M] RADE_SIMD_ALIGN;
+        float w_vec2_p_re[RADE_M] RADE_SIMD_ALIGN;
+        float w_vec2_p_im[RADE_M] RADE_SIMD_ALIGN;
 
         for (int n = 0; n < M; n++) {
             RADE_COMP w_vec1 = rade_cexp(-w * n);
-            w_vec1_p[n] = rade_cmul(w_vec1, rade_cconj(acq->p[n]));
+            RADE_COMP w_vec1_p = rade_cmul(w_vec1, rade_cconj(acq->p[n]));
+            w_vec1_p_re[n] = w_vec1_p.real;
+            w_vec1_p_im[n] = -w_vec1_p.imag;
 
             RADE_COMP w_vec2 = rade_cmul(w_vec1, rade_cexp(-w * Nmf));
-            w_vec2_p[n] = rade_cmul(w_vec2, rade_cconj(acq->p[n]));
+            RADE_COMP w_vec2_p = rade_cmul(w_vec2, rade_cconj(acq->p[n]));
+            w_vec2_p_re[n] = w_vec2_p.real;
+            w_vec2_p_im[n] = -w_vec2_p.imag;
         }
 
         for (int t = tfine_range_start; t < tfine_range_end; t++) {
             /* Correlate at this time/freq */
-            RADE_COMP Dt1 = rade_czero();
-            RADE_COMP Dt2 = rade_czero();
-
-            for (int n = 0; n < M; n++) {
-                Dt1 = rade_cadd(Dt1, rade_cmul(rx[t + n], w_vec1_p[n]));
-                Dt2 = rade_cadd(Dt2, rade_cmul(rx[t + Nmf + n], w_vec2_p[n]));
-            }
+            int i = t - tfine_range_start;
+            RADE_COMP Dt1 = rade_cdot_split(w_vec1_p_re, w_vec1_p_im, &rx1_re[i], &rx1_im[i], M, acq->arch);
+            RADE_COMP Dt2 = rade_cdot_split(w_vec2_p_re, w_vec2_p_im, &rx2_re[i], &rx2_im[i], M, acq->arch);
 
             /* Combined metric: |Dt1 + Dt2| */
             RADE_COMP Dt_sum = rade_cadd(Dt1, Dt2);
@@ -213,86 +957,120 @@ void rade_acq_refine(rade_acq *acq, const RADE_COMP *rx,
     *fmax = f_best;
 }
 
-int rade_acq_check_pilots(rade_acq *acq, const RADE_COMP *rx,
-                          int tmax, float fmax,
-                          int *valid, int *endofover) {
+void rade_acq_track(rade_acq *acq, const RADE_COMP *rx,
+                    int *tmax, float *fmax,
+                    int tfine_range_start, int tfine_range_end, float fdelta_max) {
     int M = acq->m;
-    int Ncp = acq->ncp;
     int Nmf = acq->nmf;
     float Fs = (float)acq->fs;
 
-    /* Update 5% of the correlation grid for noise estimation */
-    int Nupdate = (int)(0.05f * Nmf);
-    for (int i = 0; i < Nupdate; i++) {
-        int t = rand() % Nmf;
+    int nt = tfine_range_end - tfine_range_start;
+    if (nt <= 0) {
+        return;
+    }
+    assert(nt <= RADE_NMF);
+    float rx1_re[RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    float rx1_im[RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    float rx2_re[RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    float rx2_im[RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    rade_csplit(rx1_re, rx1_im, &rx[tfine_range_start], nt + M - 1);
+    rade_csplit(rx2_re, rx2_im, &rx[tfine_range_start + Nmf], nt + M - 1);
 
-        for (int f_idx = 0; f_idx < acq->n_fcoarse; f_idx++) {
-            RADE_COMP Dt1 = rade_czero();
-            RADE_COMP Dt2 = rade_czero();
+    /* Pilots shifted by the current estimate, as in rade_acq_check_pilots() */
+    float w = 2.0f * M_PI * (*fmax) / Fs;
+    float p_w_re[RADE_M] RADE_SIMD_ALIGN;
+    float p_w_im[RADE_M] RADE_SIMD_ALIGN;
+    for (int n = 0; n < M; n++) {
+        RADE_COMP p_w = rade_cmul(rade_cexp(w * n), acq->p[n]);
+        p_w_re[n] = p_w.real;
+        p_w_im[n] = p_w.imag;
+    }
 
-            for (int n = 0; n < M; n++) {
-                Dt1 = rade_cadd(Dt1, rade_cmul(rade_cconj(rx[t + n]), acq->p_w[n][f_idx]));
-                Dt2 = rade_cadd(Dt2, rade_cmul(rade_cconj(rx[t + Nmf + n]), acq->p_w[n][f_idx]));
-            }
+    /* Timing: |Dt1| + |Dt2| doesn't depend on the residual frequency error */
+    float Dtmax = 0.0f;
+    int t_best = *tmax;
+    RADE_COMP Dt1_best = rade_cmplx(0.0f, 0.0f);
+    RADE_COMP Dt2_best = rade_cmplx(0.0f, 0.0f);
+    for (int t = tfine_range_start; t < tfine_range_end; t++) {
+        int i = t - tfine_range_start;
+        RADE_COMP Dt1 = rade_cdot_split(&rx1_re[i], &rx1_im[i], p_w_re, p_w_im, M, acq->arch);
+        RADE_COMP Dt2 = rade_cdot_split(&rx2_re[i], &rx2_im[i], p_w_re, p_w_im, M, acq->arch);
+        float Dt = rade_cabs(Dt1) + rade_cabs(Dt2);
 
-            acq->Dt1[t][f_idx] = Dt1;
-            acq->Dt2[t][f_idx] = Dt2;
+        if (Dt > Dtmax) {
+            Dtmax = Dt;
+            t_best = t;
+            Dt1_best = Dt1;
+            Dt2_best = Dt2;
         }
     }
 
-    /* Recalculate noise statistics */
-    float sum_abs_Dt1 = 0.0f;
-    float sum_abs_Dt2 = 0.0f;
-    int count = 0;
-
-    for (int t = 0; t < Nmf; t++) {
-        for (int f_idx = 0; f_idx < acq->n_fcoarse; f_idx++) {
-            sum_abs_Dt1 += rade_cabs(acq->Dt1[t][f_idx]);
-            sum_abs_Dt2 += rade_cabs(acq->Dt2[t][f_idx]);
-            count++;
-        }
+    /* Frequency: with a residual error of d rad/sample the second pilot
+       correlation is rotated by exp(-j*(w + d)*Nmf) relative to the first.
+       Take out the w part and read d off the phase */
+    RADE_COMP r = rade_cmul(rade_cmul(Dt2_best, rade_cconj(Dt1_best)), rade_cexp(w * Nmf));
+    float fdelta = -atan2f(r.imag, r.real) * Fs / (2.0f * M_PI * Nmf);
+    if (fdelta > fdelta_max) {
+        fdelta = fdelta_max;
+    }
+    if (fdelta < -fdelta_max) {
+        fdelta = -fdelta_max;
     }
 
-    float sigma_r1 = (sum_abs_Dt1 / count) / sqrtf(M_PI / 2.0f);
-    float sigma_r2 = (sum_abs_Dt2 / count) / sqrtf(M_PI / 2.0f);
-    float sigma_r = (sigma_r1 + sigma_r2) / 2.0f;
+    *tmax = t_best;
+    *fmax += fdelta;
+}
+
+int rade_acq_check_pilots(rade_acq *acq, const RADE_COMP *rx,
+                          int tmax, float fmax,
+                          int *valid, int *endofover) {
+    int M = acq->m;
+    int Ncp = acq->ncp;
+    int Nmf = acq->nmf;
+    float Fs = (float)acq->fs;
+
+    /* Everything below correlates against rx[0 .. 2*Nmf+M-1) */
+    int n_rx = 2 * Nmf + M - 1;
+    float rx_re[2 * RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    float rx_im[2 * RADE_NMF + RADE_M] RADE_SIMD_ALIGN;
+    rade_csplit(rx_re, rx_im, rx, n_rx);
+
+    /* Noise statistics */
+    float sigma_r = acq_update_noise(acq, rx_re, rx_im, NULL, 1);
 
     acq->Dthresh = 2.0f * sigma_r * sqrtf(-logf(acq->Pacq_error2 / 5.0f));
     float Dthresh_eoo = 2.0f * sigma_r * sqrtf(-logf(acq->Pacq_error1 / 5.0f));
 
-    /* Compute correlation at current timing/freq */
+    /* Compute correlation at current timing/freq.  Rather than shifting
+       rx by exp(-j*w*n), shift the pilots the other way:
+       conj(rx * exp(-j*w*n)) * p = conj(rx) * (exp(j*w*n) * p) */
     float w = 2.0f * M_PI * fmax / Fs;
-    RADE_COMP w_vec[RADE_M];
+    float p_w_re[RADE_M] RADE_SIMD_ALIGN;
+    float p_w_im[RADE_M] RADE_SIMD_ALIGN;
+    float pend_w_re[RADE_M] RADE_SIMD_ALIGN;
+    float pend_w_im[RADE_M] RADE_SIMD_ALIGN;
     for (int n = 0; n < M; n++) {
-        w_vec[n] = rade_cexp(-w * n);
+        RADE_COMP w_vec = rade_cexp(w * n);
+        RADE_COMP p_w = rade_cmul(w_vec, acq->p[n]);
+        RADE_COMP pend_w = rade_cmul(w_vec, acq->pend[n]);
+        p_w_re[n] = p_w.real;
+        p_w_im[n] = p_w.imag;
+        pend_w_re[n] = pend_w.real;
+        pend_w_im[n] = pend_w.imag;
     }
 
     /* Correlate with normal pilots */
-    RADE_COMP Dt1 = rade_czero();
-    RADE_COMP Dt2 = rade_czero();
-    for (int n = 0; n < M; n++) {
-        RADE_COMP rx_shifted = rade_cmul(w_vec[n], rx[tmax + n]);
-        Dt1 = rade_cadd(Dt1, rade_cmul(rade_cconj(rx_shifted), acq->p[n]));
-
-        rx_shifted = rade_cmul(w_vec[n], rx[tmax + Nmf + n]);
-        Dt2 = rade_cadd(Dt2, rade_cmul(rade_cconj(rx_shifted), acq->p[n]));
-    }
+    RADE_COMP Dt1 = rade_cdot_split(&rx_re[tmax], &rx_im[tmax], p_w_re, p_w_im, M, acq->arch);
+    RADE_COMP Dt2 = rade_cdot_split(&rx_re[tmax + Nmf], &rx_im[tmax + Nmf], p_w_re, p_w_im, M, acq->arch);
 
     float Dtmax12 = rade_cabs(Dt1) + rade_cabs(Dt2);
     acq->Dtmax12 = Dtmax12;
 
-    /* Correlate with EOO pilots */
-    RADE_COMP Dt1_eoo = rade_czero();
-    RADE_COMP Dt2_eoo = rade_czero();
-    for (int n = 0; n < M; n++) {
-        /* EOO pilot at position M+Ncp after start */
-        RADE_COMP rx_shifted = rade_cmul(w_vec[n], rx[tmax + M + Ncp + n]);
-        Dt1_eoo = rade_cadd(Dt1_eoo, rade_cmul(rade_cconj(rx_shifted), acq->pend[n]));
-
-        /* EOO pilot at Nmf */
-        rx_shifted = rade_cmul(w_vec[n], rx[tmax + Nmf + n]);
-        Dt2_eoo = rade_cadd(Dt2_eoo, rade_cmul(rade_cconj(rx_shifted), acq->pend[n]));
-    }
+    /* Correlate with EOO pilots, at M+Ncp after start and at Nmf */
+    int t_eoo1 = tmax + M + Ncp;
+    int t_eoo2 = tmax + Nmf;
+    RADE_COMP Dt1_eoo = rade_cdot_split(&rx_re[t_eoo1], &rx_im[t_eoo1], pend_w_re, pend_w_im, M, acq->arch);
+    RADE_COMP Dt2_eoo = rade_cdot_split(&rx_re[t_eoo2], &rx_im[t_eoo2], pend_w_re, pend_w_im, M, acq->arch);
 
     float Dtmax12_eoo = rade_cabs(Dt1_eoo) + rade_cabs(Dt2_eoo);
     acq->Dtmax12_eoo = Dtmax12_eoo;
@@ -38,6 +38,8 @@
 
 #include "rade_dsp.h"
 #include "rade_ofdm.h"
+#include "rade_fft.h"
+#include "rade_pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -47,6 +49,15 @@ extern "C" {
                            ACQUISITION STATE
 \*---------------------------------------------------------------------------*/
 
+/* A point on the correlation grid */
+typedef struct {
+    float Dt12;                                 /* |Dt1| + |Dt2| */
+    int t;                                      /* Timing offset */
+    int f_idx;                                  /* Index into fcoarse_range */
+    float f;                                    /* Frequency offset (Hz), resolved
+                                                   to ffine_step for candidates */
+} rade_acq_peak;
+
 typedef struct {
     /* Configuration */
     int fs;                                     /* Sample rate */
@@ -57,9 +68,17 @@ typedef struct {
     /* Frequency search range */
     float fcoarse_range[RADE_ACQ_NFREQ];       /* Frequency offsets to search */
     int n_fcoarse;                              /* Number of frequency steps */
+    float fcoarse_step;                         /* Spacing of fcoarse_range */
+    float ffine_step;                           /* Resolution of reported frequencies,
+                                                   finer than fcoarse_step when the
+                                                   range needs more than
+                                                   RADE_ACQ_NFREQ steps */
 
-    /* Pre-computed frequency-shifted pilots: p_w[M][n_freq] */
-    RADE_COMP p_w[RADE_M][RADE_ACQ_NFREQ];
+    /* Pre-computed frequency-shifted pilots p_w[:][f], split into real and
+       imaginary tables so each correlation is a contiguous dot product */
+    float pw_re[RADE_ACQ_NFREQ][RADE_M];
+    float pw_im[RADE_ACQ_NFREQ][RADE_M];
+    int arch;                                   /* RADE_ARCH_xxx correlation kernel */
 
     /* Pilot power for normalization */
     float sigma_p;
@@ -68,9 +87,48 @@ typedef struct {
     RADE_COMP p[RADE_M];                        /* Time-domain pilot */
     RADE_COMP pend[RADE_M];                     /* EOO pilot */
 
-    /* Correlation grid (for threshold calculation) */
-    RADE_COMP Dt1[RADE_NMF][RADE_ACQ_NFREQ];   /* Correlation at first pilot */
-    RADE_COMP Dt2[RADE_NMF][RADE_ACQ_NFREQ];   /* Correlation at second pilot */
+    /* FFT correlator: used when every search frequency falls on a
+       Fs/RADE_ACQ_NFFT bin (true for the default 2.5 Hz step), otherwise
+       the grid is computed directly from pw_re/pw_im */
+    int fft_en;
+    int fbin[RADE_ACQ_NFREQ];                   /* Bin offset of each search frequency */
+    rade_fft_cfg fft;                           /* Forward RADE_ACQ_NFFT point FFT */
+    RADE_COMP P_fft[RADE_ACQ_NFFT];             /* FFT of p, scaled by 1/RADE_ACQ_NFFT */
+
+    /* Correlation grid magnitudes, all the peak search and threshold
+       statistics need.  Keeping |Dt| rather than Dt halves the size */
+    float abs_Dt1[RADE_NMF][RADE_ACQ_NFREQ];   /* |Dt| at first pilot */
+    float abs_Dt2[RADE_NMF][RADE_ACQ_NFREQ];   /* |Dt| at second pilot */
+
+    /* Coarse to fine search: correlate every tdecim-th timing offset, then
+       search the RADE_ACQ_TOPK best peaks again at full resolution */
+    int tdecim;                                 /* 1 = full resolution grid */
+    int Dt_step;                                /* Row step of the grid at last search */
+    rade_fft_cfg fft_decim;                     /* RADE_ACQ_NFFT/tdecim point FFT */
+
+    /* Budgeted search: each call correlates the next budget search
+       frequencies, completing the grid over several calls */
+    int budget;                                 /* 0 = whole grid every call */
+    int sweep_pos;                              /* Next search frequency */
+    int sweep_shift;                            /* Samples rx advanced since last slice */
+
+    /* Optional worker threads for the coarse search */
+    rade_pool pool;
+
+    /* Sliding acquisition: rx advancing by Nmf turns Dt2 into the next Dt1 */
+    int slide_en;                               /* Reuse Dt2 when possible */
+    int Dt2_age;                                /* Samples rx has advanced since Dt2
+                                                   was computed, -1 if not reusable */
+
+    /* Running sums of |Dt1| and |Dt2| over the grid rows in use, set by the
+       search and kept up to date as rade_acq_check_pilots() replaces rows */
+    double sum_abs_Dt1;
+    double sum_abs_Dt2;
+    int sum_count;
+
+    /* Picks the rows rade_acq_check_pilots() replaces.  Per instance, so
+       receivers in one process don't disturb each other */
+    unsigned int rand_state;
 
     /* Detection thresholds and results */
     float Dthresh;
@@ -78,6 +136,12 @@ typedef struct {
     float Dtmax12_eoo;
     int f_ind_max;
 
+    /* Separate peaks over Dthresh at the last search, strongest first.
+       cand[0] is the peak rade_acq_detect_pilots() reported */
+    rade_acq_peak cand[RADE_ACQ_TOPK];
+    int n_cand;
+    int complete;                               /* Last search completed the grid */
+
     /* Acquisition probabilities */
     float Pacq_error1;
     float Pacq_error2;
@@ -91,9 +155,51 @@ typedef struct {
 /* Initialize acquisition state
    ofdm: pointer to OFDM state (for pilot symbols)
    frange: frequency search range in Hz (e.g., 100)
-   fstep: frequency search step in Hz (e.g., 2.5) */
+   fstep: frequency search step in Hz (e.g., 2.5)
+   A range needing more than RADE_ACQ_NFREQ steps is searched on a grid of
+   RADE_ACQ_NFREQ frequencies, a multiple of fstep apart but no more than
+   RADE_ACQ_FSTEP_MAX, so the search costs the same for any range.  Peaks
+   found are then resolved to fstep.
+   rade_acq_close() acq before initialising it again */
 void rade_acq_init(rade_acq *acq, const rade_ofdm *ofdm, float frange, float fstep);
 
+/* Change the frequency search range (Hz), keeping the step given to
+   rade_acq_init().  A tdecim the new grid can't use goes back to 1.
+   Returns 0 on success, -1 if the range needs a grid step over
+   RADE_ACQ_FSTEP_MAX */
+int rade_acq_set_frange(rade_acq *acq, float frange);
+
+/* Spread the coarse search over nthreads threads, the caller plus
+   nthreads - 1 workers (1 <= nthreads <= RADE_POOL_MAXTHREADS).  Results
+   are identical for any nthreads.  Returns 0 on success, -1 on failure */
+int rade_acq_set_threads(rade_acq *acq, int nthreads);
+
+/* Coarse to fine search: correlate only every tdecim-th timing offset
+   (tdecim = 1 searches every offset, the default), then refine the best
+   RADE_ACQ_TOPK peaks at full resolution.  tdecim must divide Nmf, and
+   NFFT/2 when the FFT correlator is used.  Returns 0 on success, -1 if
+   tdecim is not supported */
+int rade_acq_set_decim(rade_acq *acq, int tdecim);
+
+/* Spread the coarse search over several calls: each call of
+   rade_acq_detect_pilots() correlates just the next nfreq search
+   frequencies, and only the call completing the grid reports a result.
+   nfreq = 0 (the default) searches the whole grid every call.  Returns 0
+   on success, -1 if nfreq is out of range */
+int rade_acq_set_budget(rade_acq *acq, int nfreq);
+
+/* Stop any worker threads started by rade_acq_set_threads() and free the
+   FFTs */
+void rade_acq_close(rade_acq *acq);
+
+/* Forget correlations carried between searches (e.g. rx buffer cleared) */
+void rade_acq_reset(rade_acq *acq);
+
+/* Tell acquisition the rx buffer has advanced by n samples since the last
+   call.  Dt2 is reused as the next Dt1 only if rx advanced by exactly Nmf
+   between two calls to rade_acq_detect_pilots() */
+void rade_acq_shift(rade_acq *acq, int n);
+
 /*---------------------------------------------------------------------------*\
                            PILOT DETECTION
 \*---------------------------------------------------------------------------*/
@@ -105,6 +211,30 @@ void rade_acq_init(rade_acq *acq, const rade_ofdm *ofdm, float frange, float fst
    Returns 1 if candidate detected, 0 otherwise */
 int rade_acq_detect_pilots(rade_acq *acq, const RADE_COMP *rx, int *tmax, float *fmax);
 
+/* Check a candidate found by rade_acq_detect_pilots() on a later frame by
+   searching only near it: timing offsets within trange of tcentre and
+   RADE_ACQ_VERIFY_NFREQ search frequencies either side of the one nearest
+   fcentre.
+   The threshold comes from the part of the search grid updated this
+   frame, as rade_acq_check_pilots() updates it.
+   rx: received samples, length = 2*Nmf + M + Ncp
+   tmax: output timing offset (samples from start of rx)
+   fmax: output frequency offset (Hz)
+   Returns 1 if the pilots are still there, 0 otherwise */
+int rade_acq_verify_pilots(rade_acq *acq, const RADE_COMP *rx, int tcentre, int trange,
+                           float fcentre, int *tmax, float *fmax);
+
+/* rade_acq_verify_pilots() for several candidates at once (e.g. acq->cand
+   from the last search), sharing one noise level update
+   n: number of candidates, 1 <= n <= RADE_ACQ_TOPK
+   tcentre, fcentre: where each candidate was found [n]
+   tmax, fmax: output timing and frequency of each candidate [n]
+   valid: output 1 if candidate i is still there [n]
+   Returns the number of candidates still there */
+int rade_acq_verify_candidates(rade_acq *acq, const RADE_COMP *rx, int n,
+                               const int *tcentre, const float *fcentre, int trange,
+                               int *tmax, float *fmax, int *valid);
+
 /* Refine timing and frequency estimates
    rx: received samples
    tmax: input/output timing estimate
@@ -116,6 +246,19 @@ void rade_acq_refine(rade_acq *acq, const RADE_COMP *rx,
                      int tfine_range_start, int tfine_range_end,
                      float ffine_range_start, float ffine_range_end, float ffine_step);
 
+/* Track timing and frequency in sync, at a fraction of the cost of
+   rade_acq_refine(): timing is the peak of |Dt1| + |Dt2| at the current
+   frequency, and the frequency error comes from the phase advance between
+   the two pilot correlations at that peak
+   rx: received samples
+   tmax: input/output timing estimate
+   fmax: input/output frequency estimate
+   tfine_range_start, tfine_range_end: timing search range
+   fdelta_max: largest frequency correction (Hz), at most Fs/(2*Nmf) */
+void rade_acq_track(rade_acq *acq, const RADE_COMP *rx,
+                    int *tmax, float *fmax,
+                    int tfine_range_start, int tfine_range_end, float fdelta_max);
+
 /* Check pilots at current timing/frequency (for sync maintenance)
    rx: received samples, length = 2*Nmf + M + Ncp
    tmax: timing offset
@@ -34,16 +34,22 @@
   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#define VERSION 2  /* Bump when API changes; version 2 = Python-free */
+#define VERSION 3  /* Bump when API changes; version 2 = Python-free, 3 = rade_model, rade_rx_batch() */
 
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
 #include "rade_api.h"
 #include "rade_tx.h"
 #include "rade_rx.h"
+#include "rade_model.h"
+#include "cpu_support.h"
 
 /*---------------------------------------------------------------------------*\
                            RADE CONTEXT
@@ -53,6 +59,8 @@ struct rade {
     int flags;
     int auxdata;
     int bottleneck;
+    int nn_arch_max;          /* Best Opus NN kernels the CPU runs */
+    struct rade_model *own_model; /* Closed with the context, from rade_open() */
 
     /* Transmitter state */
     rade_tx_state tx;
@@ -73,7 +81,45 @@ void rade_finalize(void) {
     /* No finalization needed without Python */
 }
 
+struct rade_model *rade_model_open(char model_file[]) {
+    struct rade_model *m = (struct rade_model *)malloc(sizeof(struct rade_model));
+    if (m == NULL) {
+        fprintf(stderr, "rade_model_open: failed to allocate memory\n");
+        return NULL;
+    }
+    /* rade_open() contexts always carry auxiliary data */
+    if (rade_model_init(m, model_file, 1) != 0) {
+        fprintf(stderr, "rade_model_open: failed to load the model\n");
+        free(m);
+        return NULL;
+    }
+    return m;
+}
+
+void rade_model_close(struct rade_model *m) {
+    if (m != NULL) {
+        rade_model_release(m);
+        free(m);
+    }
+}
+
 struct rade *rade_open(char model_file[], int flags) {
+    struct rade_model *m = rade_model_open(model_file);
+    if (m == NULL) {
+        return NULL;
+    }
+    struct rade *r = rade_open_model(m, flags);
+    if (r == NULL) {
+        rade_model_close(m);
+        return NULL;
+    }
+    r->own_model = m;
+    return r;
+}
+
+struct rade *rade_open_model(struct rade_model *m, int flags) {
+    assert(m != NULL);
+
     struct rade *r = (struct rade *)malloc(sizeof(struct rade));
     if (r == NULL) {
         fprintf(stderr, "rade_open: failed to allocate memory\n");
@@ -85,27 +131,31 @@ struct rade *rade_open(char model_file[], int flags) {
     r->auxdata = 1;
     r->bottleneck = 3;
 
-    /* Note: model_file is ignored in this implementation
-       Weights are compiled in via rade_enc_data.c and rade_dec_data.c */
-    //fprintf(stderr, "rade_open: model_file=%s (ignored, using built-in weights)\n", model_file);
-
     /* Initialize transmitter
        RADE_USE_C_ENCODER flag is now always implicitly set */
     int bpf_en = 0;  /* BPF disabled by default */
-    if (rade_tx_init(&r->tx, NULL, r->bottleneck, r->auxdata, bpf_en) != 0) {
+    if (rade_tx_init(&r->tx, m, r->bottleneck, r->auxdata, bpf_en) != 0) {
         fprintf(stderr, "rade_open: failed to initialize transmitter\n");
+        rade_tx_close(&r->tx);
         free(r);
         return NULL;
     }
 
     /* Initialize receiver
        RADE_USE_C_DECODER flag is now always implicitly set */
-    if (rade_rx_init(&r->rx, NULL, r->bottleneck, r->auxdata, 1) != 0) {
+    if (rade_rx_init(&r->rx, m, r->bottleneck, r->auxdata, 1) != 0) {
         fprintf(stderr, "rade_open: failed to initialize receiver\n");
+        rade_tx_close(&r->tx);
+        rade_rx_close(&r->rx);
         free(r);
         return NULL;
     }
 
+    /* Opus NN kernels for this CPU.  Without run time detection in the
+       Opus build this is 0, and Opus uses whatever it was compiled for */
+    r->nn_arch_max = opus_select_arch() & OPUS_ARCHMASK;
+    r->tx.nn_arch = r->rx.nn_arch = r->nn_arch_max;
+
     /* Set verbosity based on flags */
     if (flags & RADE_VERBOSE_0) {
         r->rx.verbose = 0;
@@ -122,6 +172,9 @@ struct rade *rade_open(char model_file[], int flags) {
 
 void rade_close(struct rade *r) {
     if (r != NULL) {
+        rade_tx_close(&r->tx);
+        rade_rx_close(&r->rx);
+        rade_model_close(r->own_model);
         free(r);
     }
 }
@@ -212,6 +265,33 @@ int rade_rx(struct rade *r, float features_out[], int *has_eoo_out, float eoo_ou
     }
 }
 
+void rade_rx_batch(struct rade *r[], int n, float *features_out[], int has_eoo_out[], float *eoo_out[],
+                   RADE_COMP *rx_in[], int n_out[]) {
+    assert(r != NULL);
+    assert(n >= 0);
+
+    for (int i0 = 0; i0 < n; i0 += RADE_NN_BATCH) {
+        int nb = (n - i0 < RADE_NN_BATCH) ? n - i0 : RADE_NN_BATCH;
+        rade_rx_state *rx[RADE_NN_BATCH];
+        const RADE_COMP *in[RADE_NN_BATCH];
+        int ret[RADE_NN_BATCH];
+
+        for (int i = 0; i < nb; i++) {
+            assert(r[i0 + i] != NULL);
+            assert(features_out[i0 + i] != NULL);
+            assert(rx_in[i0 + i] != NULL);
+            rx[i] = &r[i0 + i]->rx;
+            in[i] = rx_in[i0 + i];
+        }
+        rade_rx_process_batch(rx, nb, &features_out[i0], &eoo_out[i0], in, ret);
+
+        for (int i = 0; i < nb; i++) {
+            has_eoo_out[i0 + i] = (ret[i] & 0x2) ? 1 : 0;
+            n_out[i0 + i] = (ret[i] & 0x1) ? rade_rx_n_features_out(rx[i]) : 0;
+        }
+    }
+}
+
 int rade_sync(struct rade *r) {
     assert(r != NULL);
     return rade_rx_sync(&r->rx);
@@ -231,3 +311,60 @@ void rade_set_disable_unsync(struct rade *r, float seconds) {
     assert(r != NULL);
     r->rx.disable_unsync = seconds;
 }
+
+int rade_set_acq_threads(struct rade *r, int nthreads) {
+    assert(r != NULL);
+    return rade_acq_set_threads(&r->rx.acq, nthreads);
+}
+
+void rade_set_search_gate(struct rade *r, int period) {
+    assert(r != NULL);
+    rade_rx_set_search_gate(&r->rx, period);
+}
+
+int rade_set_acq_decimation(struct rade *r, int tdecim) {
+    assert(r != NULL);
+    return rade_acq_set_decim(&r->rx.acq, tdecim);
+}
+
+int rade_set_acq_frange(struct rade *r, float frange) {
+    assert(r != NULL);
+    return rade_rx_set_frange(&r->rx, frange);
+}
+
+int rade_set_acq_budget(struct rade *r, int nfreq) {
+    assert(r != NULL);
+    return rade_acq_set_budget(&r->rx.acq, nfreq);
+}
+
+int rade_set_nn_arch(struct rade *r, int arch) {
+    assert(r != NULL);
+    if (arch < 0 || arch > r->nn_arch_max) {
+        return -1;
+    }
+    r->tx.nn_arch = r->rx.nn_arch = arch;
+    return 0;
+}
+
+int rade_nn_arch(struct rade *r) {
+    assert(r != NULL);
+    return r->tx.nn_arch;
+}
+
+int rade_set_nn_int8(struct rade *r, int enable) {
+    assert(r != NULL);
+    int was_int8 = rade_nn_int8(r);
+    if (rade_tx_set_nn_int8(&r->tx, enable) != 0) {
+        return -1;
+    }
+    if (rade_rx_set_nn_int8(&r->rx, enable) != 0) {
+        rade_tx_set_nn_int8(&r->tx, was_int8);
+        return -1;
+    }
+    return 0;
+}
+
+int rade_nn_int8(struct rade *r) {
+    assert(r != NULL);
+    return rade_enc_int8_layers(r->tx.enc_model) > 0;
+}
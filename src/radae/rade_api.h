@@ -77,15 +77,27 @@ extern "C" {
 #define RADE_FOFF_TEST     0x4                // test mode used only by developers
 #define RADE_VERBOSE_0     0x8                // reduce verbosity to "quiet"
 
-// Must be called BEFORE any other RADE functions as this
-// initializes internal library state.
+// Kept for compatibility, the library has no global state to set up or
+// tear down so both do nothing.
 RADE_EXPORT void rade_initialize(void);
-
-// Should be called when done with RADE.
 RADE_EXPORT void rade_finalize(void);
 
-// note single context only in this version, one context has one Tx, and one Rx
+// One context has one Tx and one Rx.  All state lives in the context (and
+// its model, which is only read), so any number of contexts may run at once,
+// each on its own thread.  A single context must not be used from two
+// threads at the same time.
+// model_file may be a weight file written by write_rade_weights, which is
+// mapped read only and shared with other processes using it.  NULL or any
+// other file uses the weights built into the library
 RADE_EXPORT struct rade *rade_open(char model_file[], int flags);
+
+// The encoder and decoder weights (model_file as for rade_open()), loaded
+// once for any number of contexts.  rade_open_model() contexts hold only
+// their own Tx and Rx state, the model being shared read only.  Close the
+// model after every context using it has been closed.  Return NULL on failure
+RADE_EXPORT struct rade_model *rade_model_open(char model_file[]);
+RADE_EXPORT struct rade *rade_open_model(struct rade_model *m, int flags);
+RADE_EXPORT void rade_model_close(struct rade_model *m);
 RADE_EXPORT void rade_close(struct rade *r);
 
 // Allows API users to determine if the API has changed
@@ -119,6 +131,15 @@ RADE_EXPORT int rade_nin(struct rade *r);
 // from QPSK symbols in ..IQIQI... order
 RADE_EXPORT int rade_rx(struct rade *r, float features_out[], int *has_eoo_out, float eoo_out[], RADE_COMP rx_in[]);
 
+// rade_rx() for n independent receivers (e.g. a multi-channel skimmer),
+// each with its own nin samples in rx_in[i].  n_out[i], has_eoo_out[i] and
+// eoo_out[i] are what rade_rx() would give for r[i].  The decoder runs on
+// up to 8 receivers at once, which takes a fraction of the time per
+// receiver when they share the same model weights.  It sums in another
+// order, so features_out[i] only match rade_rx() to float rounding
+RADE_EXPORT void rade_rx_batch(struct rade *r[], int n, float *features_out[], int has_eoo_out[],
+                               float *eoo_out[], RADE_COMP *rx_in[], int n_out[]);
+
 // returns non-zero if Rx is currently in sync
 RADE_EXPORT int rade_sync(struct rade *r);
 
@@ -131,6 +152,54 @@ RADE_EXPORT int rade_snrdB_3k_est(struct rade *r);
 // test mode: disable unsync after this many seconds (0 = disabled)
 RADE_EXPORT void rade_set_disable_unsync(struct rade *r, float seconds);
 
+// spread the Rx pilot search over nthreads threads (default 1, i.e. only
+// the thread calling rade_rx()).  Decoded output is the same for any
+// nthreads.  Returns 0 on success, -1 if the threads could not be started
+RADE_EXPORT int rade_set_acq_threads(struct rade *r, int nthreads);
+
+// thin out the Rx pilot search when the input looks like noise or silence:
+// the full search then runs only every period modem frames (120 ms each),
+// so a signal is still found within period frames.  period <= 1 (the
+// default) searches every frame.  The gate is off while searching more
+// than the default frequency range (rade_set_acq_frange())
+RADE_EXPORT void rade_set_search_gate(struct rade *r, int period);
+
+// coarse to fine Rx pilot search: correlate only every tdecim-th timing
+// offset, then look again at full resolution around the best few peaks.
+// tdecim = 1 (the default) searches every offset.  Returns 0 on success,
+// -1 if tdecim is not supported (it must divide 960, the search span)
+RADE_EXPORT int rade_set_acq_decimation(struct rade *r, int tdecim);
+
+// Rx frequency offset search range in Hz, centred on the expected
+// frequency (default 100, i.e. +/- 50 Hz).  Wider ranges cost about the
+// same to search, up to 1000 Hz (+/- 500 Hz), but turn the search gate
+// off.  Resets the receiver.  Returns 0 on success, -1 if the range is not
+// supported
+RADE_EXPORT int rade_set_acq_frange(struct rade *r, float frange);
+
+// spread the Rx pilot search over several modem frames for flat CPU load:
+// each frame searches only nfreq of the 40 search frequencies (2.5 Hz
+// apart at the default range), so a complete search takes ceil(40/nfreq)
+// frames.  nfreq = 0 (the default) searches everything every frame.
+// Returns 0 on success, -1 if nfreq is out of range
+RADE_EXPORT int rade_set_acq_budget(struct rade *r, int nfreq);
+
+// Opus NN kernels used by the encoder and decoder.  rade_open() picks the
+// best the CPU supports (Opus opus_select_arch(), e.g. 4 for AVX2 on x86).
+// Force a lower one for testing, 0 being generic C.  Returns 0 on
+// success, -1 if the CPU can't run arch
+RADE_EXPORT int rade_set_nn_arch(struct rade *r, int arch);
+RADE_EXPORT int rade_nn_arch(struct rade *r);
+
+// run the encoder and decoder GRU, GLU and conv layers on int8 weights with
+// per row scales (enable = 1), a quarter of the memory traffic of their
+// float weights (0, the default).  The features differ from the float model
+// by quantisation noise, see Performance.md.  Builds with RADE_INT8_WEIGHTS
+// only have the int8 weights and start with them.  Returns 0 on success, -1
+// if the weights asked for are not in this build
+RADE_EXPORT int rade_set_nn_int8(struct rade *r, int enable);
+RADE_EXPORT int rade_nn_int8(struct rade *r);
+
 #ifdef __cplusplus
 }
 #endif
@@ -43,7 +43,7 @@
 
 void rade_bpf_init(rade_bpf *bpf, int ntap, float Fs_Hz, float bandwidth_Hz,
                    float centre_freq_Hz, int max_len) {
-    assert(ntap <= RADE_BPF_NTAP);
+    assert(ntap <= RADE_BPF_NTAP_MAX);
     assert(ntap % 2 == 1);  /* ntap should be odd for symmetric filter */
 
     bpf->ntap = ntap;
@@ -57,56 +57,153 @@ void rade_bpf_init(rade_bpf *bpf, int ntap, float Fs_Hz, float bandwidth_Hz,
     for (int i = 0; i < ntap; i++) {
         int n = i - (ntap - 1)/2;
         bpf->h[i] = B * rade_sinc(n * B);
+        bpf->h2[2 * i] = bpf->h2[2 * i + 1] = bpf->h[i];
     }
+    bpf->arch = rade_dsp_arch();
+
+    /* Complex taps, g about the centre tap and rot to take it back to hc */
+    int c = (ntap - 1) / 2;
+    for (int i = 0; i < ntap; i++) {
+        float theta = bpf->alpha * (i - c);
+        bpf->g2_re[2 * i] = bpf->g2_re[2 * i + 1] = bpf->h[i] * cosf(theta);
+        bpf->g2_im[2 * i] = bpf->g2_im[2 * i + 1] = bpf->h[i] * sinf(theta);
+    }
+    bpf->rot = rade_cmplx(cosf(bpf->alpha * c), sinf(bpf->alpha * c));
+
+    /* Overlap-save set up, H = FFT(h)/NFFT for the inverse by conjugation */
+    int ret = rade_fft_init(&bpf->fft, RADE_BPF_NFFT, 0);
+    assert(ret == 0);
+    (void)ret;
+    RADE_COMP h_pad[RADE_BPF_NFFT];
+    memset(h_pad, 0, sizeof(h_pad));
+    for (int i = 0; i < ntap; i++) {
+        h_pad[i] = rade_cmplx(bpf->h[i] / RADE_BPF_NFFT, 0.0f);
+    }
+    rade_fft(&bpf->fft, bpf->H, h_pad);
+    for (int i = 0; i < ntap; i++) {
+        float theta = bpf->alpha * i;
+        h_pad[i] = rade_cmplx(bpf->h[i] * cosf(theta) / RADE_BPF_NFFT,
+                              bpf->h[i] * sinf(theta) / RADE_BPF_NFFT);
+    }
+    rade_fft(&bpf->fft, bpf->Hc, h_pad);
+    bpf->fft_en = ntap >= ((bpf->arch == RADE_ARCH_C) ? RADE_BPF_NTAP_FFT : RADE_BPF_NTAP_FFT_SIMD);
+    bpf->cplx_en = bpf->fft_en;     /* Only pays without the direct kernel's folding */
 
     /* Initialize state */
+    rade_nco_init(&bpf->nco, -bpf->alpha);
     rade_bpf_reset(bpf);
+}
 
-    /* Pre-compute phase increment */
-    bpf->phase_inc = rade_cexp(-bpf->alpha);
+void rade_bpf_close(rade_bpf *bpf) {
+    rade_fft_close(&bpf->fft);
 }
 
 void rade_bpf_reset(rade_bpf *bpf) {
     /* Clear filter memory */
-    memset(bpf->mem, 0, sizeof(RADE_COMP) * bpf->ntap);
+    memset(bpf->mem, 0, sizeof(bpf->mem));
+    bpf->pos = 0;
 
     /* Reset mixer phase */
-    bpf->phase = rade_cone();
+    bpf->nco.phase = rade_cone();
 }
 
 /*---------------------------------------------------------------------------*\
                               PROCESSING
 \*---------------------------------------------------------------------------*/
 
-void rade_bpf_process(rade_bpf *bpf, RADE_COMP *y, const RADE_COMP *x, int n) {
-    assert(n <= bpf->max_len);
+/* FIR one sample at a time against the circular history */
+static void bpf_fir_direct(rade_bpf *bpf, RADE_COMP *y, const RADE_COMP *x, int n) {
+    int ntap = bpf->ntap;
+    int pos = bpf->pos;
+
+    for (int i = 0; i < n; i++) {
+        pos = (pos == 0) ? ntap - 1 : pos - 1;
+        bpf->mem[pos] = bpf->mem[pos + ntap] = x[i];
+        if (bpf->cplx_en) {
+            y[i] = rade_cmul(bpf->rot, rade_fir_csym(&bpf->mem[pos], bpf->g2_re, bpf->g2_im,
+                                                     ntap, bpf->arch));
+        } else {
+            y[i] = rade_fir_sym(&bpf->mem[pos], bpf->h2, ntap, bpf->arch);
+        }
+    }
+
+    bpf->pos = pos;
+}
 
+/* FIR n <= RADE_BPF_NFFT - (ntap-1) samples by overlap-save: the last
+   ntap-1 samples then the new ones, zero padded, times H (or Hc).  The inverse
+   FFT is conj(FFT(conj())), with its 1/NFFT already in H */
+static void bpf_fir_ols(rade_bpf *bpf, RADE_COMP *y, const RADE_COMP *x, int n) {
     int ntap = bpf->ntap;
-    RADE_COMP phase = bpf->phase;
-    RADE_COMP phase_inc = bpf->phase_inc;
+    int nhist = ntap - 1;
+    RADE_COMP in[RADE_BPF_NFFT];
+    RADE_COMP X[RADE_BPF_NFFT];
+    RADE_COMP out[RADE_BPF_NFFT];
+    assert(nhist + n <= RADE_BPF_NFFT);
+
+    for (int k = 0; k < nhist; k++) {
+        in[nhist - 1 - k] = bpf->mem[bpf->pos + k];
+    }
+    memcpy(&in[nhist], x, sizeof(RADE_COMP) * n);
+    memset(&in[nhist + n], 0, sizeof(RADE_COMP) * (RADE_BPF_NFFT - nhist - n));
 
-    /* Process each sample */
+    rade_fft(&bpf->fft, X, in);
+    const RADE_COMP *H = bpf->cplx_en ? bpf->Hc : bpf->H;
+    for (int k = 0; k < RADE_BPF_NFFT; k++) {
+        X[k] = rade_cconj(rade_cmul(X[k], H[k]));
+    }
+    rade_fft(&bpf->fft, out, X);
     for (int i = 0; i < n; i++) {
-        /* Mix down to baseband: x_bb = x * exp(-j*alpha*(i+1)) */
-        phase = rade_cmul(bpf->phase, rade_cexp(-bpf->alpha*(i+1)));
-        RADE_COMP x_bb = rade_cmul(x[i], phase);
+        y[i] = rade_cconj(out[nhist + i]);
+    }
 
-        /* Shift filter memory and add new sample */
-        memmove(&bpf->mem[1], &bpf->mem[0], sizeof(RADE_COMP) * (ntap - 1));
-        bpf->mem[0] = x_bb;
+    /* Leave the history as the direct path would */
+    for (int k = 0; k < ntap; k++) {
+        bpf->mem[k] = bpf->mem[k + ntap] = in[nhist + n - 1 - k];
+    }
+    bpf->pos = 0;
+}
 
-        /* FIR filter: y_bb = sum(h[k] * mem[k])
-           Since h is real and symmetric, we can optimize but keep simple for now */
-        RADE_COMP y_bb = rade_cdot_float(bpf->mem, bpf->h, ntap);
-        
-        /* Mix back up to centre frequency: y = y_bb * conj(phase) */
-        RADE_COMP cconj_phase = rade_cconj(phase);
-        y[i] = rade_cmul(y_bb, cconj_phase);
+void rade_bpf_process(rade_bpf *bpf, RADE_COMP *y, const RADE_COMP *x, int n) {
+    assert(n <= bpf->max_len);
+
+    int nblock = RADE_BPF_NFFT - (bpf->ntap - 1);
+    RADE_COMP phase[RADE_BPF_NFFT];
+    RADE_COMP x_bb[RADE_BPF_NFFT];
+    RADE_COMP y_bb[RADE_BPF_NFFT];
+
+    /* No mixers, the passband straight through hc */
+    if (bpf->cplx_en) {
+        for (int i0 = 0; i0 < n; i0 += nblock) {
+            int len = (n - i0 < nblock) ? n - i0 : nblock;
+            if (bpf->fft_en) {
+                bpf_fir_ols(bpf, &y[i0], &x[i0], len);
+            } else {
+                bpf_fir_direct(bpf, &y[i0], &x[i0], len);
+            }
+        }
+        return;
     }
 
-    /* Save phase state for next call
-       Normalize to prevent drift */
-    float phase_mag = rade_cabs(phase);
-    bpf->phase.real = phase.real; // / phase_mag;
-    bpf->phase.imag = phase.imag; // / phase_mag;
+    for (int i0 = 0; i0 < n; i0 += nblock) {
+        int len = (n - i0 < nblock) ? n - i0 : nblock;
+
+        /* Mix down to baseband: x_bb = x * exp(-j*alpha*(i+1)) */
+        rade_nco_gen(&bpf->nco, phase, len);
+        for (int i = 0; i < len; i++) {
+            x_bb[i] = rade_cmul(x[i0 + i], phase[i]);
+        }
+
+        /* Lowpass FIR filter: y_bb = sum(h[k] * x_bb[i-k]) */
+        if (bpf->fft_en) {
+            bpf_fir_ols(bpf, y_bb, x_bb, len);
+        } else {
+            bpf_fir_direct(bpf, y_bb, x_bb, len);
+        }
+
+        /* Mix back up to centre frequency: y = y_bb * conj(phase) */
+        for (int i = 0; i < len; i++) {
+            y[i0 + i] = rade_cmul(y_bb[i], rade_cconj(phase[i]));
+        }
+    }
 }
@@ -38,6 +38,7 @@
 #define __RADE_BPF__
 
 #include "rade_dsp.h"
+#include "rade_fft.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -50,11 +51,36 @@ extern "C" {
 typedef struct {
     int ntap;                               /* Number of filter taps */
     float alpha;                            /* 2*pi*centre_freq/Fs (rad/sample) */
-    float h[RADE_BPF_NTAP];                /* Filter coefficients (real, symmetric) */
-    RADE_COMP mem[RADE_BPF_NTAP];          /* Filter memory/state */
-    RADE_COMP phase;                        /* Mixer phase state */
-    RADE_COMP phase_inc;                    /* Phase increment per sample */
+    float h[RADE_BPF_NTAP_MAX];             /* Filter coefficients (real, symmetric) */
+    float h2[2 * RADE_BPF_NTAP_MAX];        /* h with each tap twice, for rade_fir_sym() */
+
+    /* Complex taps: the mixers folded into the filter.  Mixing down by
+       exp(-j*alpha*n), filtering and mixing back up is the time invariant
+       filter hc[k] = h[k]*exp(j*alpha*k) = rot*g[k], where
+       g[k] = h[k]*exp(j*alpha*(k - (ntap-1)/2)) is conjugate symmetric */
+    float g2_re[2 * RADE_BPF_NTAP_MAX];     /* Re(g), Im(g) with each tap twice, */
+    float g2_im[2 * RADE_BPF_NTAP_MAX];     /* for rade_fir_csym() */
+    RADE_COMP rot;                          /* exp(j*alpha*(ntap-1)/2) */
+
+    /* Input history, newest first from mem[pos].  Each sample is stored
+       at pos and pos + ntap so the last ntap are always contiguous.
+       Baseband with the mixers, passband with complex taps */
+    RADE_COMP mem[2 * RADE_BPF_NTAP_MAX];
+    int pos;
+
+    rade_nco nco;                           /* Mixer, exp(-j*alpha*n) */
+    int cplx_en;                            /* Filter with hc rather than mix and h */
     int max_len;                            /* Maximum input length */
+    int arch;                               /* rade_dsp_arch() kernels */
+
+    /* Overlap-save: blocks of RADE_BPF_NFFT - (ntap-1) samples filtered
+       in the frequency domain.  Set at init when it is the faster of the
+       two for ntap (RADE_BPF_NTAP_FFT, RADE_BPF_NTAP_FFT_SIMD).  Either way
+       gives the same output, and it may be switched at any time */
+    int fft_en;
+    rade_fft_cfg fft;                       /* Forward RADE_BPF_NFFT point FFT */
+    RADE_COMP H[RADE_BPF_NFFT];             /* FFT of h, scaled by 1/RADE_BPF_NFFT */
+    RADE_COMP Hc[RADE_BPF_NFFT];            /* FFT of hc, scaled by 1/RADE_BPF_NFFT */
 } rade_bpf;
 
 /*---------------------------------------------------------------------------*\
@@ -62,14 +88,21 @@ typedef struct {
 \*---------------------------------------------------------------------------*/
 
 /* Initialize BPF with specified parameters
-   ntap: number of filter taps (should be odd, typically 101)
+   ntap: number of filter taps (odd, typically 101, at most RADE_BPF_NTAP_MAX)
    Fs_Hz: sample rate in Hz
    bandwidth_Hz: filter bandwidth in Hz
    centre_freq_Hz: centre frequency in Hz
-   max_len: maximum input block length */
+   max_len: maximum input block length
+   cplx_en is set to the faster of the two forms for this ntap and kernel.
+   It may be changed before the first rade_bpf_process() or straight after
+   rade_bpf_reset(), as the history is held differently for each.
+   bpf must be zeroed, or set up by an earlier rade_bpf_init() */
 void rade_bpf_init(rade_bpf *bpf, int ntap, float Fs_Hz, float bandwidth_Hz,
                    float centre_freq_Hz, int max_len);
 
+/* Free the FFT set up by rade_bpf_init() */
+void rade_bpf_close(rade_bpf *bpf);
+
 /* Reset BPF state (clear memory and phase) */
 void rade_bpf_reset(rade_bpf *bpf);
 
@@ -87,7 +120,8 @@ void rade_bpf_reset(rade_bpf *bpf);
    2. Applies lowpass FIR filter
    3. Mixes result back up to centre frequency
 
-   This effectively creates a bandpass filter centered at centre_freq_Hz
+   or with cplx_en filters with the complex taps hc in one step, the same
+   output to rounding.  This effectively creates a bandpass filter centered at centre_freq_Hz
    with bandwidth bandwidth_Hz. The negative frequency image is suppressed. */
 void rade_bpf_process(rade_bpf *bpf, RADE_COMP *y, const RADE_COMP *x, int n);
 
@@ -29,10 +29,55 @@
 #include "config.h"
 #endif
 
+#include <assert.h>
+#include <stdlib.h>
+
 #include "rade_dec.h"
+#include "rade_dsp.h"
 #include "../src/radae_top/rade_constants.h"
 #include "os_support.h"
 
+#define DEC_BUFFER_SIZE (DEC_DENSE1_OUT_SIZE + DEC_GRU1_OUT_SIZE + DEC_GRU2_OUT_SIZE + DEC_GRU3_OUT_SIZE + DEC_GRU4_OUT_SIZE + DEC_GRU5_OUT_SIZE \
+                         + DEC_CONV1_OUT_SIZE + DEC_CONV2_OUT_SIZE + DEC_CONV3_OUT_SIZE + DEC_CONV4_OUT_SIZE + DEC_CONV5_OUT_SIZE)
+#define DEC_MAX_STATE   DEC_GRU1_STATE_SIZE
+#define DEC_MAX_INPUTS  (2 * DEC_BUFFER_SIZE)
+
+#define DEC_NB_LAYERS   22
+
+static void dec_layers(const RADEDec *model, const LinearLayer **layers)
+{
+    const LinearLayer *all[DEC_NB_LAYERS] = {
+        &model->dec_dense1, &model->dec_output,
+        &model->dec_gru1_input, &model->dec_gru1_recurrent, &model->dec_glu1, &model->dec_conv1,
+        &model->dec_gru2_input, &model->dec_gru2_recurrent, &model->dec_glu2, &model->dec_conv2,
+        &model->dec_gru3_input, &model->dec_gru3_recurrent, &model->dec_glu3, &model->dec_conv3,
+        &model->dec_gru4_input, &model->dec_gru4_recurrent, &model->dec_glu4, &model->dec_conv4,
+        &model->dec_gru5_input, &model->dec_gru5_recurrent, &model->dec_glu5, &model->dec_conv5
+    };
+    OPUS_COPY(layers, all, DEC_NB_LAYERS);
+}
+
+void rade_dec_use_int8(RADEDec *model)
+{
+    int i;
+    const LinearLayer *layers[DEC_NB_LAYERS];
+    dec_layers(model, layers);
+    for (i=0;i<DEC_NB_LAYERS;i++) {
+        if (layers[i]->weights != NULL) ((LinearLayer *)layers[i])->float_weights = NULL;
+    }
+}
+
+int rade_dec_int8_layers(const RADEDec *model)
+{
+    int i, n=0;
+    const LinearLayer *layers[DEC_NB_LAYERS];
+    dec_layers(model, layers);
+    for (i=0;i<DEC_NB_LAYERS;i++) {
+        if (layers[i]->weights != NULL && layers[i]->float_weights == NULL) n++;
+    }
+    return n;
+}
+
 void rade_init_decoder(RADEDecState *dec_state)
 {
     memset(dec_state, 0, sizeof(*dec_state));
@@ -100,3 +145,171 @@ void rade_core_decoder(
 
     compute_generic_dense(&model->dec_output, features, buffer, ACTIVATION_LINEAR, arch);
 }
+
+/* Batched decoder.  The linear part of each layer is one matrix product
+   over the streams, rade_sgemm_cm() or rade_sparse_sgemm8x4() on the Opus
+   float weights; activations and the GRU/GLU/conv1d glue follow the Opus
+   compute_generic_*() code stream by stream.  The scratch is 87 KB,
+   too much for the stack of a caller's thread, so it comes from the heap */
+
+typedef struct {
+    float buffer[RADE_NN_BATCH][DEC_BUFFER_SIZE];
+    float in[RADE_NN_BATCH][DEC_MAX_INPUTS];
+    float zrh[RADE_NN_BATCH][3 * DEC_MAX_STATE];
+    float recur[RADE_NN_BATCH][3 * DEC_MAX_STATE];
+} dec_batch_scratch;
+
+static int dec_batch_supported(const RADEDec *model)
+{
+    int i;
+    const LinearLayer *layers[DEC_NB_LAYERS];
+    dec_layers(model, layers);
+    for (i=0;i<DEC_NB_LAYERS;i++) {
+        if (layers[i]->float_weights == NULL) return 0;
+    }
+    return 1;
+}
+
+/* compute_linear() for nb inputs, in[b*in_stride] -> out[b*out_stride] */
+static void linear_batch(const LinearLayer *layer, float *out, int out_stride,
+                         const float *in, int in_stride, int nb, int dsp_arch)
+{
+    int b, i;
+    int M = layer->nb_inputs;
+    int N = layer->nb_outputs;
+
+    if (layer->weights_idx != NULL) {
+        rade_sparse_sgemm8x4(out, out_stride, layer->float_weights, layer->weights_idx, N,
+                             in, in_stride, nb, dsp_arch);
+    } else {
+        rade_sgemm_cm(out, out_stride, layer->float_weights, N, M, in, in_stride, nb, dsp_arch);
+    }
+    for (b=0;b<nb;b++) {
+        float *y = &out[b*out_stride];
+        const float *x = &in[b*in_stride];
+        if (layer->bias != NULL) {
+            for (i=0;i<N;i++) y[i] += layer->bias[i];
+        }
+        if (layer->diag != NULL) {
+            for (i=0;i<M;i++) {
+                y[i] += layer->diag[i]*x[i];
+                y[i+M] += layer->diag[i+M]*x[i];
+                y[i+2*M] += layer->diag[i+2*M]*x[i];
+            }
+        }
+    }
+}
+
+/* compute_generic_gru() on buffer, then compute_glu() of the new state
+   into buffer[out_index] */
+static void gru_glu_batch(dec_batch_scratch *s, const LinearLayer *input_weights,
+                          const LinearLayer *recurrent_weights, const LinearLayer *glu,
+                          float **state, int out_index, int nb, int arch, int dsp_arch)
+{
+    int b, i;
+    int N = recurrent_weights->nb_inputs;
+    assert(N <= DEC_MAX_STATE && glu->nb_inputs == N);
+
+    for (b=0;b<nb;b++) OPUS_COPY(s->in[b], state[b], N);
+    linear_batch(input_weights, s->zrh[0], 3*DEC_MAX_STATE, s->buffer[0], DEC_BUFFER_SIZE, nb, dsp_arch);
+    linear_batch(recurrent_weights, s->recur[0], 3*DEC_MAX_STATE, s->in[0], DEC_MAX_INPUTS, nb, dsp_arch);
+
+    for (b=0;b<nb;b++) {
+        float *z = s->zrh[b];
+        float *r = &s->zrh[b][N];
+        float *h = &s->zrh[b][2*N];
+        for (i=0;i<2*N;i++) s->zrh[b][i] += s->recur[b][i];
+        compute_activation(s->zrh[b], s->zrh[b], 2*N, ACTIVATION_SIGMOID, arch);
+        for (i=0;i<N;i++) h[i] += s->recur[b][2*N+i]*r[i];
+        compute_activation(h, h, N, ACTIVATION_TANH, arch);
+        for (i=0;i<N;i++) h[i] = z[i]*state[b][i] + (1-z[i])*h[i];
+        OPUS_COPY(state[b], h, N);
+        OPUS_COPY(s->in[b], h, N);
+    }
+
+    /* GLU of the new state, act2 in recur */
+    linear_batch(glu, s->recur[0], 3*DEC_MAX_STATE, s->in[0], DEC_MAX_INPUTS, nb, dsp_arch);
+    for (b=0;b<nb;b++) {
+        compute_activation(s->recur[b], s->recur[b], N, ACTIVATION_SIGMOID, arch);
+        for (i=0;i<N;i++) s->buffer[b][out_index+i] = state[b][i]*s->recur[b][i];
+    }
+}
+
+/* compute_generic_conv1d() of buffer[0..input_size) into buffer[input_size] */
+static void conv1d_batch(dec_batch_scratch *s, const LinearLayer *layer, float **mem,
+                         int *initialized, int input_size, int nb, int arch, int dsp_arch)
+{
+    int b;
+    int nmem = layer->nb_inputs - input_size;
+    assert(layer->nb_inputs <= DEC_MAX_INPUTS);
+
+    for (b=0;b<nb;b++) {
+        conv1_cond_init(mem[b], input_size, 1, &initialized[b]);
+        OPUS_COPY(s->in[b], mem[b], nmem);
+        OPUS_COPY(&s->in[b][nmem], s->buffer[b], input_size);
+    }
+    linear_batch(layer, &s->buffer[0][input_size], DEC_BUFFER_SIZE, s->in[0], DEC_MAX_INPUTS, nb, dsp_arch);
+    for (b=0;b<nb;b++) {
+        compute_activation(&s->buffer[b][input_size], &s->buffer[b][input_size], layer->nb_outputs, ACTIVATION_TANH, arch);
+        OPUS_COPY(mem[b], &s->in[b][input_size], nmem);
+    }
+}
+
+void rade_core_decoder_batch(
+    RADEDecState  **dec_states,
+    const RADEDec *model,
+    float         **features,       /* o: four concatenated feature vecs per stream */
+    const float   **latents,        /* i: latent vector per stream */
+    int nb,
+    int arch
+    )
+{
+    dec_batch_scratch *s;
+    float *state[RADE_NN_BATCH];
+    int initialized[RADE_NN_BATCH];
+    int dsp_arch = arch ? rade_dsp_arch() : RADE_ARCH_C;
+    int b0, b, n;
+
+    s = dec_batch_supported(model) ? (dec_batch_scratch *)malloc(sizeof(dec_batch_scratch)) : NULL;
+    if (s == NULL) {
+        for (b=0;b<nb;b++) rade_core_decoder(dec_states[b], model, features[b], latents[b], arch);
+        return;
+    }
+
+    for (b0=0;b0<nb;b0+=RADE_NN_BATCH) {
+        RADEDecState **st = &dec_states[b0];
+        int output_index = 0;
+        n = (nb - b0 < RADE_NN_BATCH) ? nb - b0 : RADE_NN_BATCH;
+
+        for (b=0;b<n;b++) {
+            OPUS_COPY(s->in[b], latents[b0+b], model->dec_dense1.nb_inputs);
+            initialized[b] = st[b]->initialized;
+        }
+        linear_batch(&model->dec_dense1, s->buffer[0], DEC_BUFFER_SIZE, s->in[0], DEC_MAX_INPUTS, n, dsp_arch);
+        for (b=0;b<n;b++) compute_activation(s->buffer[b], s->buffer[b], DEC_DENSE1_OUT_SIZE, ACTIVATION_TANH, arch);
+        output_index += DEC_DENSE1_OUT_SIZE;
+
+#define DEC_BATCH_STAGE(k) \
+        for (b=0;b<n;b++) state[b] = st[b]->gru##k##_state; \
+        gru_glu_batch(s, &model->dec_gru##k##_input, &model->dec_gru##k##_recurrent, &model->dec_glu##k, \
+                      state, output_index, n, arch, dsp_arch); \
+        output_index += DEC_GRU##k##_OUT_SIZE; \
+        for (b=0;b<n;b++) state[b] = st[b]->conv##k##_state; \
+        conv1d_batch(s, &model->dec_conv##k, state, initialized, output_index, n, arch, dsp_arch); \
+        output_index += DEC_CONV##k##_OUT_SIZE;
+
+        DEC_BATCH_STAGE(1)
+        DEC_BATCH_STAGE(2)
+        DEC_BATCH_STAGE(3)
+        DEC_BATCH_STAGE(4)
+        DEC_BATCH_STAGE(5)
+#undef DEC_BATCH_STAGE
+
+        linear_batch(&model->dec_output, s->zrh[0], 3*DEC_MAX_STATE, s->buffer[0], DEC_BUFFER_SIZE, n, dsp_arch);
+        for (b=0;b<n;b++) {
+            OPUS_COPY(features[b0+b], s->zrh[b], model->dec_output.nb_outputs);
+            st[b]->initialized = initialized[b];
+        }
+    }
+    free(s);
+}
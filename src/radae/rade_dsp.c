@@ -36,6 +36,14 @@
 #include "rade_dsp.h"
 #include <string.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RADE_HAVE_AVX2
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define RADE_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
 /*---------------------------------------------------------------------------*\
                            VECTOR OPERATIONS
 \*---------------------------------------------------------------------------*/
@@ -51,6 +59,342 @@ RADE_COMP rade_cdot(const RADE_COMP *a, const RADE_COMP *b, int n) {
     return result;
 }
 
+int rade_dsp_arch(void) {
+#if defined(RADE_HAVE_AVX2)
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return RADE_ARCH_AVX2;
+    }
+    return RADE_ARCH_C;
+#elif defined(RADE_HAVE_NEON)
+    return RADE_ARCH_NEON;
+#else
+    return RADE_ARCH_C;
+#endif
+}
+
+void rade_csplit(float *re, float *im, const RADE_COMP *x, int n) {
+    for (int i = 0; i < n; i++) {
+        re[i] = x[i].real;
+        im[i] = x[i].imag;
+    }
+}
+
+static RADE_COMP cdot_split_c(const float *a_re, const float *a_im,
+                              const float *b_re, const float *b_im, int n) {
+    RADE_COMP result = rade_czero();
+    for (int i = 0; i < n; i++) {
+        result.real += a_re[i] * b_re[i] + a_im[i] * b_im[i];
+        result.imag += a_re[i] * b_im[i] - a_im[i] * b_re[i];
+    }
+    return result;
+}
+
+#if defined(RADE_HAVE_AVX2)
+__attribute__((target("avx2,fma")))
+static RADE_COMP cdot_split_avx2(const float *a_re, const float *a_im,
+                                 const float *b_re, const float *b_im, int n) {
+    /* Separate accumulators for the four partial products keep the
+       FMA units busy instead of waiting on one dependency chain */
+    __m256 rr = _mm256_setzero_ps();
+    __m256 ii = _mm256_setzero_ps();
+    __m256 ri = _mm256_setzero_ps();
+    __m256 ir = _mm256_setzero_ps();
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256 ar = _mm256_loadu_ps(&a_re[i]);
+        __m256 ai = _mm256_loadu_ps(&a_im[i]);
+        __m256 br = _mm256_loadu_ps(&b_re[i]);
+        __m256 bi = _mm256_loadu_ps(&b_im[i]);
+        rr = _mm256_fmadd_ps(ar, br, rr);
+        ii = _mm256_fmadd_ps(ai, bi, ii);
+        ri = _mm256_fmadd_ps(ar, bi, ri);
+        ir = _mm256_fmadd_ps(ai, br, ir);
+    }
+
+    __m256 re8 = _mm256_add_ps(rr, ii);
+    __m256 im8 = _mm256_sub_ps(ri, ir);
+    __m128 re4 = _mm_add_ps(_mm256_castps256_ps128(re8), _mm256_extractf128_ps(re8, 1));
+    __m128 im4 = _mm_add_ps(_mm256_castps256_ps128(im8), _mm256_extractf128_ps(im8, 1));
+    re4 = _mm_add_ps(re4, _mm_movehl_ps(re4, re4));
+    im4 = _mm_add_ps(im4, _mm_movehl_ps(im4, im4));
+    re4 = _mm_add_ss(re4, _mm_shuffle_ps(re4, re4, 1));
+    im4 = _mm_add_ss(im4, _mm_shuffle_ps(im4, im4, 1));
+    RADE_COMP result = rade_cmplx(_mm_cvtss_f32(re4), _mm_cvtss_f32(im4));
+
+    /* Tail kept in this function: calling SSE code with the upper
+       halves of the ymm registers dirty stalls on many x86 cores */
+    _mm256_zeroupper();
+    for (; i < n; i++) {
+        result.real += a_re[i] * b_re[i] + a_im[i] * b_im[i];
+        result.imag += a_re[i] * b_im[i] - a_im[i] * b_re[i];
+    }
+    return result;
+}
+#endif
+
+#if defined(RADE_HAVE_NEON)
+static RADE_COMP cdot_split_neon(const float *a_re, const float *a_im,
+                                 const float *b_re, const float *b_im, int n) {
+    float32x4_t rr = vdupq_n_f32(0.0f);
+    float32x4_t ii = vdupq_n_f32(0.0f);
+    float32x4_t ri = vdupq_n_f32(0.0f);
+    float32x4_t ir = vdupq_n_f32(0.0f);
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t ar = vld1q_f32(&a_re[i]);
+        float32x4_t ai = vld1q_f32(&a_im[i]);
+        float32x4_t br = vld1q_f32(&b_re[i]);
+        float32x4_t bi = vld1q_f32(&b_im[i]);
+        rr = vfmaq_f32(rr, ar, br);
+        ii = vfmaq_f32(ii, ai, bi);
+        ri = vfmaq_f32(ri, ar, bi);
+        ir = vfmaq_f32(ir, ai, br);
+    }
+
+    RADE_COMP tail = cdot_split_c(&a_re[i], &a_im[i], &b_re[i], &b_im[i], n - i);
+    return rade_cmplx(vaddvq_f32(vaddq_f32(rr, ii)) + tail.real,
+                      vaddvq_f32(vsubq_f32(ri, ir)) + tail.imag);
+}
+#endif
+
+RADE_COMP rade_cdot_split(const float *a_re, const float *a_im,
+                          const float *b_re, const float *b_im, int n, int arch) {
+    switch (arch) {
+#if defined(RADE_HAVE_AVX2)
+    case RADE_ARCH_AVX2: return cdot_split_avx2(a_re, a_im, b_re, b_im, n);
+#endif
+#if defined(RADE_HAVE_NEON)
+    case RADE_ARCH_NEON: return cdot_split_neon(a_re, a_im, b_re, b_im, n);
+#endif
+    default: return cdot_split_c(a_re, a_im, b_re, b_im, n);
+    }
+}
+
+static RADE_COMP fir_sym_c(const RADE_COMP *x, const float *h2, int ntap) {
+    int nfold = ntap / 2;
+    float re0 = 0.0f, im0 = 0.0f, re1 = 0.0f, im1 = 0.0f;
+    int k = 0;
+
+    for (; k + 2 <= nfold; k += 2) {
+        const RADE_COMP *a = &x[k];
+        const RADE_COMP *b = &x[ntap - 1 - k];
+        re0 += h2[2 * k] * (a[0].real + b[0].real);
+        im0 += h2[2 * k] * (a[0].imag + b[0].imag);
+        re1 += h2[2 * k + 2] * (a[1].real + b[-1].real);
+        im1 += h2[2 * k + 2] * (a[1].imag + b[-1].imag);
+    }
+    for (; k < nfold; k++) {
+        re0 += h2[2 * k] * (x[k].real + x[ntap - 1 - k].real);
+        im0 += h2[2 * k] * (x[k].imag + x[ntap - 1 - k].imag);
+    }
+
+    /* Centre tap */
+    re0 += h2[2 * nfold] * x[nfold].real;
+    im0 += h2[2 * nfold] * x[nfold].imag;
+    return rade_cmplx(re0 + re1, im0 + im1);
+}
+
+#if defined(RADE_HAVE_AVX2)
+__attribute__((target("avx2,fma")))
+static RADE_COMP fir_sym_avx2(const RADE_COMP *x, const float *h2, int ntap) {
+    const float *xf = (const float *)x;
+    int nfold = ntap / 2;
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int k = 0;
+
+    /* 4 complex from the front, the 4 mirroring them from the back with
+       their order reversed, as 64 bit lanes */
+    for (; k + 8 <= nfold; k += 8) {
+        __m256 a0 = _mm256_loadu_ps(&xf[2 * k]);
+        __m256 a1 = _mm256_loadu_ps(&xf[2 * k + 8]);
+        __m256 b0 = _mm256_loadu_ps(&xf[2 * (ntap - 4 - k)]);
+        __m256 b1 = _mm256_loadu_ps(&xf[2 * (ntap - 8 - k)]);
+        b0 = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(b0), 0x1B));
+        b1 = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(b1), 0x1B));
+        acc0 = _mm256_fmadd_ps(_mm256_add_ps(a0, b0), _mm256_loadu_ps(&h2[2 * k]), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_add_ps(a1, b1), _mm256_loadu_ps(&h2[2 * k + 8]), acc1);
+    }
+    for (; k + 4 <= nfold; k += 4) {
+        __m256 a0 = _mm256_loadu_ps(&xf[2 * k]);
+        __m256 b0 = _mm256_loadu_ps(&xf[2 * (ntap - 4 - k)]);
+        b0 = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(b0), 0x1B));
+        acc0 = _mm256_fmadd_ps(_mm256_add_ps(a0, b0), _mm256_loadu_ps(&h2[2 * k]), acc0);
+    }
+
+    /* Even lanes are real, odd imaginary */
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 s = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    s = _mm_add_ps(s, _mm_movehl_ps(s, s));
+    RADE_COMP result = rade_cmplx(_mm_cvtss_f32(s), _mm_cvtss_f32(_mm_shuffle_ps(s, s, 1)));
+
+    _mm256_zeroupper();
+    for (; k < nfold; k++) {
+        result.real += h2[2 * k] * (x[k].real + x[ntap - 1 - k].real);
+        result.imag += h2[2 * k] * (x[k].imag + x[ntap - 1 - k].imag);
+    }
+    result.real += h2[2 * nfold] * x[nfold].real;
+    result.imag += h2[2 * nfold] * x[nfold].imag;
+    return result;
+}
+#endif
+
+#if defined(RADE_HAVE_NEON)
+static RADE_COMP fir_sym_neon(const RADE_COMP *x, const float *h2, int ntap) {
+    const float *xf = (const float *)x;
+    int nfold = ntap / 2;
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    int k = 0;
+
+    /* 2 complex per vector, the mirrored pair swapped into order */
+    for (; k + 4 <= nfold; k += 4) {
+        float32x4_t a0 = vld1q_f32(&xf[2 * k]);
+        float32x4_t a1 = vld1q_f32(&xf[2 * k + 4]);
+        float32x4_t b0 = vld1q_f32(&xf[2 * (ntap - 2 - k)]);
+        float32x4_t b1 = vld1q_f32(&xf[2 * (ntap - 4 - k)]);
+        b0 = vcombine_f32(vget_high_f32(b0), vget_low_f32(b0));
+        b1 = vcombine_f32(vget_high_f32(b1), vget_low_f32(b1));
+        acc0 = vfmaq_f32(acc0, vaddq_f32(a0, b0), vld1q_f32(&h2[2 * k]));
+        acc1 = vfmaq_f32(acc1, vaddq_f32(a1, b1), vld1q_f32(&h2[2 * k + 4]));
+    }
+
+    float32x4_t acc = vaddq_f32(acc0, acc1);
+    float32x2_t s = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    RADE_COMP result = rade_cmplx(vget_lane_f32(s, 0), vget_lane_f32(s, 1));
+
+    for (; k < nfold; k++) {
+        result.real += h2[2 * k] * (x[k].real + x[ntap - 1 - k].real);
+        result.imag += h2[2 * k] * (x[k].imag + x[ntap - 1 - k].imag);
+    }
+    result.real += h2[2 * nfold] * x[nfold].real;
+    result.imag += h2[2 * nfold] * x[nfold].imag;
+    return result;
+}
+#endif
+
+/* g*a + conj(g)*b = g_re*(a+b) + j*g_im*(a-b) */
+static RADE_COMP fir_csym_c(const RADE_COMP *x, const float *g2_re, const float *g2_im, int ntap) {
+    int nfold = ntap / 2;
+    float s_re = 0.0f, s_im = 0.0f, d_re = 0.0f, d_im = 0.0f;
+
+    for (int k = 0; k < nfold; k++) {
+        const RADE_COMP a = x[k];
+        const RADE_COMP b = x[ntap - 1 - k];
+        s_re += g2_re[2 * k] * (a.real + b.real);
+        s_im += g2_re[2 * k] * (a.imag + b.imag);
+        d_re += g2_im[2 * k] * (a.real - b.real);
+        d_im += g2_im[2 * k] * (a.imag - b.imag);
+    }
+
+    /* Centre tap is real */
+    s_re += g2_re[2 * nfold] * x[nfold].real;
+    s_im += g2_re[2 * nfold] * x[nfold].imag;
+    return rade_cmplx(s_re - d_im, s_im + d_re);
+}
+
+#if defined(RADE_HAVE_AVX2)
+__attribute__((target("avx2,fma")))
+static RADE_COMP fir_csym_avx2(const RADE_COMP *x, const float *g2_re, const float *g2_im, int ntap) {
+    const float *xf = (const float *)x;
+    int nfold = ntap / 2;
+    __m256 s = _mm256_setzero_ps();
+    __m256 d = _mm256_setzero_ps();
+    int k = 0;
+
+    for (; k + 4 <= nfold; k += 4) {
+        __m256 a = _mm256_loadu_ps(&xf[2 * k]);
+        __m256 b = _mm256_loadu_ps(&xf[2 * (ntap - 4 - k)]);
+        b = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(b), 0x1B));
+        s = _mm256_fmadd_ps(_mm256_add_ps(a, b), _mm256_loadu_ps(&g2_re[2 * k]), s);
+        d = _mm256_fmadd_ps(_mm256_sub_ps(a, b), _mm256_loadu_ps(&g2_im[2 * k]), d);
+    }
+
+    /* Even lanes are real, odd imaginary */
+    __m128 s4 = _mm_add_ps(_mm256_castps256_ps128(s), _mm256_extractf128_ps(s, 1));
+    __m128 d4 = _mm_add_ps(_mm256_castps256_ps128(d), _mm256_extractf128_ps(d, 1));
+    s4 = _mm_add_ps(s4, _mm_movehl_ps(s4, s4));
+    d4 = _mm_add_ps(d4, _mm_movehl_ps(d4, d4));
+    float s_re = _mm_cvtss_f32(s4), s_im = _mm_cvtss_f32(_mm_shuffle_ps(s4, s4, 1));
+    float d_re = _mm_cvtss_f32(d4), d_im = _mm_cvtss_f32(_mm_shuffle_ps(d4, d4, 1));
+
+    _mm256_zeroupper();
+    for (; k < nfold; k++) {
+        const RADE_COMP a = x[k];
+        const RADE_COMP b = x[ntap - 1 - k];
+        s_re += g2_re[2 * k] * (a.real + b.real);
+        s_im += g2_re[2 * k] * (a.imag + b.imag);
+        d_re += g2_im[2 * k] * (a.real - b.real);
+        d_im += g2_im[2 * k] * (a.imag - b.imag);
+    }
+    s_re += g2_re[2 * nfold] * x[nfold].real;
+    s_im += g2_re[2 * nfold] * x[nfold].imag;
+    return rade_cmplx(s_re - d_im, s_im + d_re);
+}
+#endif
+
+#if defined(RADE_HAVE_NEON)
+static RADE_COMP fir_csym_neon(const RADE_COMP *x, const float *g2_re, const float *g2_im, int ntap) {
+    const float *xf = (const float *)x;
+    int nfold = ntap / 2;
+    float32x4_t s = vdupq_n_f32(0.0f);
+    float32x4_t d = vdupq_n_f32(0.0f);
+    int k = 0;
+
+    for (; k + 2 <= nfold; k += 2) {
+        float32x4_t a = vld1q_f32(&xf[2 * k]);
+        float32x4_t b = vld1q_f32(&xf[2 * (ntap - 2 - k)]);
+        b = vcombine_f32(vget_high_f32(b), vget_low_f32(b));
+        s = vfmaq_f32(s, vaddq_f32(a, b), vld1q_f32(&g2_re[2 * k]));
+        d = vfmaq_f32(d, vsubq_f32(a, b), vld1q_f32(&g2_im[2 * k]));
+    }
+
+    float32x2_t s2 = vadd_f32(vget_low_f32(s), vget_high_f32(s));
+    float32x2_t d2 = vadd_f32(vget_low_f32(d), vget_high_f32(d));
+    float s_re = vget_lane_f32(s2, 0), s_im = vget_lane_f32(s2, 1);
+    float d_re = vget_lane_f32(d2, 0), d_im = vget_lane_f32(d2, 1);
+
+    for (; k < nfold; k++) {
+        const RADE_COMP a = x[k];
+        const RADE_COMP b = x[ntap - 1 - k];
+        s_re += g2_re[2 * k] * (a.real + b.real);
+        s_im += g2_re[2 * k] * (a.imag + b.imag);
+        d_re += g2_im[2 * k] * (a.real - b.real);
+        d_im += g2_im[2 * k] * (a.imag - b.imag);
+    }
+    s_re += g2_re[2 * nfold] * x[nfold].real;
+    s_im += g2_re[2 * nfold] * x[nfold].imag;
+    return rade_cmplx(s_re - d_im, s_im + d_re);
+}
+#endif
+
+RADE_COMP rade_fir_csym(const RADE_COMP *x, const float *g2_re, const float *g2_im,
+                        int ntap, int arch) {
+    switch (arch) {
+#if defined(RADE_HAVE_AVX2)
+    case RADE_ARCH_AVX2: return fir_csym_avx2(x, g2_re, g2_im, ntap);
+#endif
+#if defined(RADE_HAVE_NEON)
+    case RADE_ARCH_NEON: return fir_csym_neon(x, g2_re, g2_im, ntap);
+#endif
+    default: return fir_csym_c(x, g2_re, g2_im, ntap);
+    }
+}
+
+RADE_COMP rade_fir_sym(const RADE_COMP *x, const float *h2, int ntap, int arch) {
+    switch (arch) {
+#if defined(RADE_HAVE_AVX2)
+    case RADE_ARCH_AVX2: return fir_sym_avx2(x, h2, ntap);
+#endif
+#if defined(RADE_HAVE_NEON)
+    case RADE_ARCH_NEON: return fir_sym_neon(x, h2, ntap);
+#endif
+    default: return fir_sym_c(x, h2, ntap);
+    }
+}
+
 /* Complex matrix-vector multiply: y = A * x
    A is [rows x cols], x is [cols], y is [rows]
    Matrix A is stored row-major: A[row][col] = A[row*cols + col] */
@@ -80,6 +424,323 @@ void rade_cmvmul_real(RADE_COMP *y, const float *A, const RADE_COMP *x, int rows
     }
 }
 
+/*---------------------------------------------------------------------------*\
+                        NUMERICALLY CONTROLLED OSCILLATOR
+\*---------------------------------------------------------------------------*/
+
+void rade_nco_init(rade_nco *nco, float w) {
+    nco->phase = rade_cone();
+    rade_nco_set_freq(nco, w);
+}
+
+void rade_nco_set_freq(rade_nco *nco, float w) {
+    nco->w = w;
+    for (int i = 0; i < RADE_NCO_BLOCK; i++) {
+        nco->step[i] = rade_cexp(w * (i + 1));
+    }
+}
+
+void rade_nco_gen(rade_nco *nco, RADE_COMP *out, int n) {
+    RADE_COMP phase = nco->phase;
+
+    for (int i0 = 0; i0 < n; i0 += RADE_NCO_BLOCK) {
+        int len = (n - i0 < RADE_NCO_BLOCK) ? n - i0 : RADE_NCO_BLOCK;
+        for (int i = 0; i < len; i++) {
+            out[i0 + i] = rade_cmul(phase, nco->step[i]);
+        }
+
+        /* Carry on from the last sample, first order correction of |phase|
+           back towards 1 as rounding wanders off it */
+        phase = out[i0 + len - 1];
+        phase = rade_cscale(phase, 0.5f * (3.0f - rade_cabs2(phase)));
+    }
+
+    nco->phase = phase;
+}
+
+void rade_nco_mix(rade_nco *nco, RADE_COMP *y, const RADE_COMP *x, int n) {
+    RADE_COMP ph[RADE_NCO_BLOCK];
+
+    for (int i0 = 0; i0 < n; i0 += RADE_NCO_BLOCK) {
+        int len = (n - i0 < RADE_NCO_BLOCK) ? n - i0 : RADE_NCO_BLOCK;
+        rade_nco_gen(nco, ph, len);
+        for (int i = 0; i < len; i++) {
+            y[i0 + i] = rade_cmul(x[i0 + i], ph[i]);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*\
+                         BATCHED MATRIX PRODUCTS
+\*---------------------------------------------------------------------------*/
+
+/* Rows i0 .. i0+nr-1 of y = W x, W with leading dimension ld.  Each output
+   sums its inputs in order, like the Opus single vector kernels */
+static void sgemm_cm_c(float *y, int y_stride, const float *W, int ld, int i0, int nr, int cols,
+                       const float *x, int x_stride, int nb) {
+    for (; nr > 0; i0 += 16, nr -= 16) {
+        int n = (nr < 16) ? nr : 16;
+        for (int b = 0; b < nb; b++) {
+            const float *xb = &x[b * x_stride];
+            float acc[16] = { 0 };
+            for (int j = 0; j < cols; j++) {
+                const float *w = &W[j * ld + i0];
+                for (int k = 0; k < n; k++) {
+                    acc[k] += w[k] * xb[j];
+                }
+            }
+            memcpy(&y[b * y_stride + i0], acc, sizeof(float) * n);
+        }
+    }
+}
+
+static void sparse_sgemm8x4_c(float *y, int y_stride, const float *w, const int *idx, int rows,
+                              const float *x, int x_stride, int nb) {
+    for (int i = 0; i < rows; i += 8) {
+        int nblk = *idx++;
+        for (int b = 0; b < nb; b++) {
+            const float *xb = &x[b * x_stride];
+            const float *wb = w;
+            float acc[8] = { 0 };
+            for (int k = 0; k < nblk; k++) {
+                const float *xk = &xb[idx[k]];
+                for (int c = 0; c < 4; c++) {
+                    for (int r = 0; r < 8; r++) {
+                        acc[r] += wb[8 * c + r] * xk[c];
+                    }
+                }
+                wb += 32;
+            }
+            memcpy(&y[b * y_stride + i], acc, sizeof(acc));
+        }
+        idx += nblk;
+        w += 32 * nblk;
+    }
+}
+
+#if defined(RADE_HAVE_AVX2)
+/* 16 rows at a time for 4 vectors at a time, 8 accumulators.  The 16 x cols
+   slice of W is then reused from cache by the remaining vectors */
+__attribute__((target("avx2,fma")))
+static void sgemm_cm_avx2(float *y, int y_stride, const float *W, int rows, int cols,
+                          const float *x, int x_stride, int nb) {
+    int i0 = 0;
+    for (; i0 + 16 <= rows; i0 += 16) {
+        int b = 0;
+        for (; b + 4 <= nb; b += 4) {
+            const float *x0 = &x[b * x_stride];
+            const float *x1 = x0 + x_stride, *x2 = x1 + x_stride, *x3 = x2 + x_stride;
+            __m256 a0 = _mm256_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+            __m256 a4 = a0, a5 = a0, a6 = a0, a7 = a0;
+            for (int j = 0; j < cols; j++) {
+                __m256 wl = _mm256_loadu_ps(&W[j * rows + i0]);
+                __m256 wh = _mm256_loadu_ps(&W[j * rows + i0 + 8]);
+                __m256 v = _mm256_broadcast_ss(&x0[j]);
+                a0 = _mm256_fmadd_ps(wl, v, a0);
+                a1 = _mm256_fmadd_ps(wh, v, a1);
+                v = _mm256_broadcast_ss(&x1[j]);
+                a2 = _mm256_fmadd_ps(wl, v, a2);
+                a3 = _mm256_fmadd_ps(wh, v, a3);
+                v = _mm256_broadcast_ss(&x2[j]);
+                a4 = _mm256_fmadd_ps(wl, v, a4);
+                a5 = _mm256_fmadd_ps(wh, v, a5);
+                v = _mm256_broadcast_ss(&x3[j]);
+                a6 = _mm256_fmadd_ps(wl, v, a6);
+                a7 = _mm256_fmadd_ps(wh, v, a7);
+            }
+            float *yb = &y[b * y_stride + i0];
+            _mm256_storeu_ps(yb, a0);
+            _mm256_storeu_ps(yb + 8, a1);
+            _mm256_storeu_ps(yb + y_stride, a2);
+            _mm256_storeu_ps(yb + y_stride + 8, a3);
+            _mm256_storeu_ps(yb + 2 * y_stride, a4);
+            _mm256_storeu_ps(yb + 2 * y_stride + 8, a5);
+            _mm256_storeu_ps(yb + 3 * y_stride, a6);
+            _mm256_storeu_ps(yb + 3 * y_stride + 8, a7);
+        }
+        for (; b < nb; b++) {
+            const float *xb = &x[b * x_stride];
+            __m256 a0 = _mm256_setzero_ps(), a1 = a0;
+            for (int j = 0; j < cols; j++) {
+                __m256 v = _mm256_broadcast_ss(&xb[j]);
+                a0 = _mm256_fmadd_ps(_mm256_loadu_ps(&W[j * rows + i0]), v, a0);
+                a1 = _mm256_fmadd_ps(_mm256_loadu_ps(&W[j * rows + i0 + 8]), v, a1);
+            }
+            _mm256_storeu_ps(&y[b * y_stride + i0], a0);
+            _mm256_storeu_ps(&y[b * y_stride + i0 + 8], a1);
+        }
+    }
+    _mm256_zeroupper();
+
+    /* Left over rows */
+    sgemm_cm_c(y, y_stride, W, rows, i0, rows - i0, cols, x, x_stride, nb);
+}
+
+/* 8 rows, one register, for 4 vectors at a time */
+__attribute__((target("avx2,fma")))
+static void sparse_sgemm8x4_avx2(float *y, int y_stride, const float *w, const int *idx, int rows,
+                                 const float *x, int x_stride, int nb) {
+    for (int i = 0; i < rows; i += 8) {
+        int nblk = *idx++;
+        int b = 0;
+        for (; b + 4 <= nb; b += 4) {
+            const float *x0 = &x[b * x_stride];
+            const float *x1 = x0 + x_stride, *x2 = x1 + x_stride, *x3 = x2 + x_stride;
+            const float *wb = w;
+            __m256 a0 = _mm256_setzero_ps(), a1 = a0, a2 = a0, a3 = a0;
+            for (int k = 0; k < nblk; k++) {
+                int pos = idx[k];
+                for (int c = 0; c < 4; c++) {
+                    __m256 wc = _mm256_loadu_ps(&wb[8 * c]);
+                    a0 = _mm256_fmadd_ps(wc, _mm256_broadcast_ss(&x0[pos + c]), a0);
+                    a1 = _mm256_fmadd_ps(wc, _mm256_broadcast_ss(&x1[pos + c]), a1);
+                    a2 = _mm256_fmadd_ps(wc, _mm256_broadcast_ss(&x2[pos + c]), a2);
+                    a3 = _mm256_fmadd_ps(wc, _mm256_broadcast_ss(&x3[pos + c]), a3);
+                }
+                wb += 32;
+            }
+            _mm256_storeu_ps(&y[b * y_stride + i], a0);
+            _mm256_storeu_ps(&y[(b + 1) * y_stride + i], a1);
+            _mm256_storeu_ps(&y[(b + 2) * y_stride + i], a2);
+            _mm256_storeu_ps(&y[(b + 3) * y_stride + i], a3);
+        }
+        for (; b < nb; b++) {
+            const float *xb = &x[b * x_stride];
+            const float *wb = w;
+            __m256 a0 = _mm256_setzero_ps();
+            for (int k = 0; k < nblk; k++) {
+                int pos = idx[k];
+                for (int c = 0; c < 4; c++) {
+                    a0 = _mm256_fmadd_ps(_mm256_loadu_ps(&wb[8 * c]), _mm256_broadcast_ss(&xb[pos + c]), a0);
+                }
+                wb += 32;
+            }
+            _mm256_storeu_ps(&y[b * y_stride + i], a0);
+        }
+        idx += nblk;
+        w += 32 * nblk;
+    }
+    _mm256_zeroupper();
+}
+#endif
+
+#if defined(RADE_HAVE_NEON)
+/* As AVX2, 16 rows in four registers for 4 vectors at a time */
+static void sgemm_cm_neon(float *y, int y_stride, const float *W, int rows, int cols,
+                          const float *x, int x_stride, int nb) {
+    int i0 = 0;
+    for (; i0 + 16 <= rows; i0 += 16) {
+        int b = 0;
+        for (; b + 4 <= nb; b += 4) {
+            float32x4_t a[4][4];
+            for (int s = 0; s < 4; s++) {
+                for (int q = 0; q < 4; q++) {
+                    a[s][q] = vdupq_n_f32(0.0f);
+                }
+            }
+            for (int j = 0; j < cols; j++) {
+                const float *w = &W[j * rows + i0];
+                float32x4_t w0 = vld1q_f32(w), w1 = vld1q_f32(w + 4);
+                float32x4_t w2 = vld1q_f32(w + 8), w3 = vld1q_f32(w + 12);
+                for (int s = 0; s < 4; s++) {
+                    float xs = x[(b + s) * x_stride + j];
+                    a[s][0] = vfmaq_n_f32(a[s][0], w0, xs);
+                    a[s][1] = vfmaq_n_f32(a[s][1], w1, xs);
+                    a[s][2] = vfmaq_n_f32(a[s][2], w2, xs);
+                    a[s][3] = vfmaq_n_f32(a[s][3], w3, xs);
+                }
+            }
+            for (int s = 0; s < 4; s++) {
+                for (int q = 0; q < 4; q++) {
+                    vst1q_f32(&y[(b + s) * y_stride + i0 + 4 * q], a[s][q]);
+                }
+            }
+        }
+        for (; b < nb; b++) {
+            const float *xb = &x[b * x_stride];
+            float32x4_t a0 = vdupq_n_f32(0.0f), a1 = a0, a2 = a0, a3 = a0;
+            for (int j = 0; j < cols; j++) {
+                const float *w = &W[j * rows + i0];
+                a0 = vfmaq_n_f32(a0, vld1q_f32(w), xb[j]);
+                a1 = vfmaq_n_f32(a1, vld1q_f32(w + 4), xb[j]);
+                a2 = vfmaq_n_f32(a2, vld1q_f32(w + 8), xb[j]);
+                a3 = vfmaq_n_f32(a3, vld1q_f32(w + 12), xb[j]);
+            }
+            float *yb = &y[b * y_stride + i0];
+            vst1q_f32(yb, a0);
+            vst1q_f32(yb + 4, a1);
+            vst1q_f32(yb + 8, a2);
+            vst1q_f32(yb + 12, a3);
+        }
+    }
+
+    sgemm_cm_c(y, y_stride, W, rows, i0, rows - i0, cols, x, x_stride, nb);
+}
+
+static void sparse_sgemm8x4_neon(float *y, int y_stride, const float *w, const int *idx, int rows,
+                                 const float *x, int x_stride, int nb) {
+    for (int i = 0; i < rows; i += 8) {
+        int nblk = *idx++;
+        int b = 0;
+        for (; b + 4 <= nb; b += 4) {
+            float32x4_t a[4][2];
+            for (int s = 0; s < 4; s++) {
+                a[s][0] = a[s][1] = vdupq_n_f32(0.0f);
+            }
+            const float *wb = w;
+            for (int k = 0; k < nblk; k++) {
+                int pos = idx[k];
+                for (int c = 0; c < 4; c++) {
+                    float32x4_t wl = vld1q_f32(&wb[8 * c]), wh = vld1q_f32(&wb[8 * c + 4]);
+                    for (int s = 0; s < 4; s++) {
+                        float xs = x[(b + s) * x_stride + pos + c];
+                        a[s][0] = vfmaq_n_f32(a[s][0], wl, xs);
+                        a[s][1] = vfmaq_n_f32(a[s][1], wh, xs);
+                    }
+                }
+                wb += 32;
+            }
+            for (int s = 0; s < 4; s++) {
+                vst1q_f32(&y[(b + s) * y_stride + i], a[s][0]);
+                vst1q_f32(&y[(b + s) * y_stride + i + 4], a[s][1]);
+            }
+        }
+        if (b < nb) {
+            sparse_sgemm8x4_c(&y[b * y_stride + i], y_stride, w, idx - 1, 8,
+                              &x[b * x_stride], x_stride, nb - b);
+        }
+        idx += nblk;
+        w += 32 * nblk;
+    }
+}
+#endif
+
+void rade_sgemm_cm(float *y, int y_stride, const float *W, int rows, int cols,
+                   const float *x, int x_stride, int nb, int arch) {
+    switch (arch) {
+#if defined(RADE_HAVE_AVX2)
+    case RADE_ARCH_AVX2: sgemm_cm_avx2(y, y_stride, W, rows, cols, x, x_stride, nb); break;
+#endif
+#if defined(RADE_HAVE_NEON)
+    case RADE_ARCH_NEON: sgemm_cm_neon(y, y_stride, W, rows, cols, x, x_stride, nb); break;
+#endif
+    default: sgemm_cm_c(y, y_stride, W, rows, 0, rows, cols, x, x_stride, nb); break;
+    }
+}
+
+void rade_sparse_sgemm8x4(float *y, int y_stride, const float *w, const int *idx, int rows,
+                          const float *x, int x_stride, int nb, int arch) {
+    switch (arch) {
+#if defined(RADE_HAVE_AVX2)
+    case RADE_ARCH_AVX2: sparse_sgemm8x4_avx2(y, y_stride, w, idx, rows, x, x_stride, nb); break;
+#endif
+#if defined(RADE_HAVE_NEON)
+    case RADE_ARCH_NEON: sparse_sgemm8x4_neon(y, y_stride, w, idx, rows, x, x_stride, nb); break;
+#endif
+    default: sparse_sgemm8x4_c(y, y_stride, w, idx, rows, x, x_stride, nb); break;
+    }
+}
+
 /*---------------------------------------------------------------------------*\
                            PILOT GENERATION
 \*---------------------------------------------------------------------------*/
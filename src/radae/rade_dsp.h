@@ -70,24 +70,41 @@ extern "C" {
 #define RADE_NUM_FEATURES       20      /* Base vocoder features */
 #define RADE_NUM_FEATURES_AUX   21      /* With auxiliary data */
 #define RADE_NB_TOTAL_FEATURES  36      /* Total feature vector size (padded) */
+#define RADE_NN_BATCH           8       /* Decoder streams run together */
 
 /* BPF parameters */
 #define RADE_BPF_NTAP           101     /* BPF filter taps */
+#define RADE_BPF_NTAP_MAX       255     /* Longest BPF supported */
+#define RADE_BPF_NFFT           512     /* Overlap-save FFT length */
+#define RADE_BPF_NTAP_FFT       81      /* Overlap-save from this long, portable C kernel */
+#define RADE_BPF_NTAP_FFT_SIMD  255     /* Overlap-save from this long, SIMD kernels */
 
 /* Acquisition parameters */
 #define RADE_ACQ_FRANGE         100.0f  /* Frequency search range (Hz) */
 #define RADE_ACQ_FSTEP          2.5f    /* Frequency search step (Hz) */
 #define RADE_ACQ_NFREQ          40      /* Number of frequency search steps */
+#define RADE_ACQ_FSTEP_MAX      25.0f   /* Widest step of a wide search grid (Hz) */
+#define RADE_ACQ_NFFT           3200    /* FFT correlator length, Fs/NFFT = 2.5 Hz bins */
 #define RADE_ACQ_PACQ_ERR1      0.00001f /* Acquisition error probability 1 */
 #define RADE_ACQ_PACQ_ERR2      0.0001f  /* Acquisition error probability 2 */
+#define RADE_ACQ_TOPK           4       /* Separate peaks kept by each search */
+#define RADE_ACQ_CAND_RATIO     0.5f    /* Weakest candidate relative to the strongest */
+#define RADE_ACQ_VERIFY_NFREQ   2       /* Candidate check: +/- search frequencies */
+
+/* Search gate parameters */
+#define RADE_GATE_THRESH        1.5f    /* Carrier/reference energy ratio over noise floor to open */
+#define RADE_GATE_NGUARD        2       /* Bins between carriers and reference bands */
+#define RADE_GATE_NREF          6       /* Bins in each reference band */
 
 /* Receiver state machine */
 #define RADE_STATE_SEARCH       0
 #define RADE_STATE_CANDIDATE    1
 #define RADE_STATE_SYNC         2
+#define RADE_STATE_LOST         3       /* Recently lost, probing where it was */
 
 /* Timing constants */
 #define RADE_TUNSYNC            3.0f    /* Time before losing sync (seconds) */
+#define RADE_TLOST              3.0f    /* Time to probe a lost signal's last timing/freq (seconds) */
 #define RADE_UW_ERROR_THRESH    7       /* Unique word error threshold */
 
 /* Pilot symbols - Barker-13 code */
@@ -246,6 +263,30 @@ static inline RADE_COMP rade_cdot_float(const RADE_COMP* a, const float* b, int
 /* Complex dot product: sum(conj(a[i]) * b[i]) */
 RADE_COMP rade_cdot(const RADE_COMP *a, const RADE_COMP *b, int n);
 
+/* Kernel implementations, chosen at run time like the Opus arch argument */
+#define RADE_ARCH_C             0       /* Portable C */
+#define RADE_ARCH_AVX2          1       /* x86 AVX2 + FMA */
+#define RADE_ARCH_NEON          2       /* AArch64 NEON */
+
+/* Alignment of split complex buffers on the stack, one AVX register.  The
+   kernels use unaligned loads, so this only saves split cache lines */
+#if defined(__GNUC__)
+#define RADE_SIMD_ALIGN         __attribute__((aligned(32)))
+#else
+#define RADE_SIMD_ALIGN
+#endif
+
+/* Fastest kernel implementation supported by this CPU */
+int rade_dsp_arch(void);
+
+/* Split complex vector x[n] into separate real and imaginary arrays */
+void rade_csplit(float *re, float *im, const RADE_COMP *x, int n);
+
+/* Complex dot product of split vectors: sum(conj(a[i]) * b[i])
+   Summation order depends on arch, so results differ by rounding only */
+RADE_COMP rade_cdot_split(const float *a_re, const float *a_im,
+                          const float *b_re, const float *b_im, int n, int arch);
+
 /* Complex matrix-vector multiply: y = A * x
    A is [rows x cols], x is [cols], y is [rows] */
 void rade_cmvmul(RADE_COMP *y, const RADE_COMP *A, const RADE_COMP *x, int rows, int cols);
@@ -254,6 +295,66 @@ void rade_cmvmul(RADE_COMP *y, const RADE_COMP *A, const RADE_COMP *x, int rows,
    A is [rows x cols] (real), x is [cols] (complex), y is [rows] (complex) */
 void rade_cmvmul_real(RADE_COMP *y, const float *A, const RADE_COMP *x, int rows, int cols);
 
+/* FIR output with symmetric real taps: sum(h[k] * x[k]), k = 0..ntap-1,
+   ntap odd.  Taps are given twice over, h2[2k] = h2[2k+1] = h[k], to line
+   up with the interleaved re/im of x.  Mirrored samples are added before
+   the multiply, so it costs (ntap+1)/2 complex by real MACs */
+RADE_COMP rade_fir_sym(const RADE_COMP *x, const float *h2, int ntap, int arch);
+
+/* FIR output with conjugate symmetric complex taps, g[ntap-1-k] = conj(g[k]):
+   sum(g[k] * x[k]), ntap odd.  g2_re/g2_im hold the real and imaginary
+   parts of g twice over like rade_fir_sym().  Mirrored samples are summed
+   for the real part and differenced for the imaginary part */
+RADE_COMP rade_fir_csym(const RADE_COMP *x, const float *g2_re, const float *g2_im,
+                        int ntap, int arch);
+
+/*---------------------------------------------------------------------------*\
+                        NUMERICALLY CONTROLLED OSCILLATOR
+\*---------------------------------------------------------------------------*/
+
+#define RADE_NCO_BLOCK          16      /* Samples per NCO block */
+
+/* exp(j*w*n) without per sample sinf/cosf.  Each block of RADE_NCO_BLOCK
+   samples is the phase at the end of the previous block times a table of
+   exp(j*w*(i+1)), so the samples within a block don't depend on each
+   other.  The phase is pulled back to unit magnitude once per block */
+typedef struct {
+    float w;                                    /* rad/sample */
+    RADE_COMP phase;                            /* Phasor of the last sample out */
+    RADE_COMP step[RADE_NCO_BLOCK];             /* exp(j*w*(i+1)) */
+} rade_nco;
+
+/* Set up at frequency w (rad/sample), phase 0 */
+void rade_nco_init(rade_nco *nco, float w);
+
+/* Change frequency, the phase carries on from where it is */
+void rade_nco_set_freq(rade_nco *nco, float w);
+
+/* Next n phasors: out[i] = phase * exp(j*w*(i+1)), then phase = out[n-1] */
+void rade_nco_gen(rade_nco *nco, RADE_COMP *out, int n);
+
+/* Mix x[n] by the next n phasors: y[i] = x[i] * out[i], y may alias x */
+void rade_nco_mix(rade_nco *nco, RADE_COMP *y, const RADE_COMP *x, int n);
+
+/*---------------------------------------------------------------------------*\
+                         BATCHED MATRIX PRODUCTS
+\*---------------------------------------------------------------------------*/
+
+/* Matrix products over nb input vectors at once, for running one NN layer
+   for several streams: every weight is read once per call rather than once
+   per vector.  Weights are in the Opus float layouts.  Vector b is read
+   from x[b*x_stride] and written to y[b*y_stride] */
+
+/* Dense: y = W x, W rows x cols column major, W[j*rows + i] (Opus sgemv()) */
+void rade_sgemm_cm(float *y, int y_stride, const float *W, int rows, int cols,
+                   const float *x, int x_stride, int nb, int arch);
+
+/* Block sparse (Opus sparse_sgemv8x4()): for each 8 rows idx holds the
+   number of 4 input blocks then their first inputs, and w their 8x4
+   weights column major.  rows is a multiple of 8 */
+void rade_sparse_sgemm8x4(float *y, int y_stride, const float *w, const int *idx, int rows,
+                          const float *x, int x_stride, int nb, int arch);
+
 /*---------------------------------------------------------------------------*\
                            DSP UTILITIES
 \*---------------------------------------------------------------------------*/
@@ -36,6 +36,42 @@
 #include "os_support.h"
 #include "../src/radae_top/rade_constants.h"
 
+#define ENC_NB_LAYERS   17
+
+static void enc_layers(const RADEEnc *model, const LinearLayer **layers)
+{
+    const LinearLayer *all[ENC_NB_LAYERS] = {
+        &model->enc_dense1, &model->enc_zdense,
+        &model->enc_gru1_input, &model->enc_gru1_recurrent, &model->enc_conv1,
+        &model->enc_gru2_input, &model->enc_gru2_recurrent, &model->enc_conv2,
+        &model->enc_gru3_input, &model->enc_gru3_recurrent, &model->enc_conv3,
+        &model->enc_gru4_input, &model->enc_gru4_recurrent, &model->enc_conv4,
+        &model->enc_gru5_input, &model->enc_gru5_recurrent, &model->enc_conv5
+    };
+    OPUS_COPY(layers, all, ENC_NB_LAYERS);
+}
+
+void rade_enc_use_int8(RADEEnc *model)
+{
+    int i;
+    const LinearLayer *layers[ENC_NB_LAYERS];
+    enc_layers(model, layers);
+    for (i=0;i<ENC_NB_LAYERS;i++) {
+        if (layers[i]->weights != NULL) ((LinearLayer *)layers[i])->float_weights = NULL;
+    }
+}
+
+int rade_enc_int8_layers(const RADEEnc *model)
+{
+    int i, n=0;
+    const LinearLayer *layers[ENC_NB_LAYERS];
+    enc_layers(model, layers);
+    for (i=0;i<ENC_NB_LAYERS;i++) {
+        if (layers[i]->weights != NULL && layers[i]->float_weights == NULL) n++;
+    }
+    return n;
+}
+
 void rade_init_encoder(RADEEncState *enc_state)
 {
     memset(enc_state, 0, sizeof(*enc_state));
@@ -0,0 +1,233 @@
+/*---------------------------------------------------------------------------*\
+
+  rade_fft.c
+
+  Mixed-radix (2, 3, 4, 5) complex FFT for RADAE C implementation.
+  Decimation in time, out-of-place, same structure as kiss_fft.
+
+\*---------------------------------------------------------------------------*/
+
+/*
+  Copyright (C) 2024 David Rowe
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  - Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE FOUNDATION OR
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "rade_fft.h"
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+/*---------------------------------------------------------------------------*\
+                           INITIALIZATION
+\*---------------------------------------------------------------------------*/
+
+/* Split n into radix stages, preferring radix 4, then 2, 3 and 5.
+   Stored as (radix, remaining length) pairs.  Returns -1 if n has a
+   prime factor we have no butterfly for. */
+static int fft_factor(int n, int *factors) {
+    int p = 4;
+    int nstages = 0;
+
+    while (n > 1) {
+        while (n % p) {
+            switch (p) {
+            case 4: p = 2; break;
+            case 2: p = 3; break;
+            case 3: p = 5; break;
+            default: return -1;
+            }
+        }
+        if (nstages == RADE_FFT_MAXFACTORS) {
+            return -1;
+        }
+        n /= p;
+        factors[2 * nstages] = p;
+        factors[2 * nstages + 1] = n;
+        nstages++;
+    }
+
+    return 0;
+}
+
+int rade_fft_init(rade_fft_cfg *cfg, int nfft, int inverse) {
+    RADE_COMP *twiddles = cfg->twiddles;
+    memset(cfg, 0, sizeof(rade_fft_cfg));
+
+    if (nfft < 2 || nfft > RADE_FFT_NMAX || fft_factor(nfft, cfg->factors) != 0) {
+        free(twiddles);
+        return -1;
+    }
+
+    /* Only as long as this transform, most are far shorter than NMAX */
+    cfg->twiddles = (RADE_COMP *)realloc(twiddles, sizeof(RADE_COMP) * nfft);
+    if (cfg->twiddles == NULL) {
+        free(twiddles);
+        return -1;
+    }
+    cfg->nfft = nfft;
+    cfg->inverse = inverse;
+
+    /* Twiddles computed in double so long transforms stay accurate */
+    double sign = inverse ? 1.0 : -1.0;
+    for (int k = 0; k < nfft; k++) {
+        double theta = sign * 2.0 * M_PI * k / nfft;
+        cfg->twiddles[k].real = (float)cos(theta);
+        cfg->twiddles[k].imag = (float)sin(theta);
+    }
+
+    return 0;
+}
+
+void rade_fft_close(rade_fft_cfg *cfg) {
+    free(cfg->twiddles);
+    memset(cfg, 0, sizeof(rade_fft_cfg));
+}
+
+/*---------------------------------------------------------------------------*\
+                              BUTTERFLIES
+\*---------------------------------------------------------------------------*/
+
+static void fft_bfly2(RADE_COMP *fout, int fstride, const rade_fft_cfg *cfg, int m) {
+    const RADE_COMP *tw = cfg->twiddles;
+
+    for (int k = 0; k < m; k++) {
+        RADE_COMP t = rade_cmul(fout[m + k], tw[k * fstride]);
+        fout[m + k] = rade_csub(fout[k], t);
+        fout[k] = rade_cadd(fout[k], t);
+    }
+}
+
+static void fft_bfly3(RADE_COMP *fout, int fstride, const rade_fft_cfg *cfg, int m) {
+    const RADE_COMP *tw = cfg->twiddles;
+    float epi3 = tw[fstride * m].imag;          /* -/+ sin(2*pi/3) */
+
+    for (int k = 0; k < m; k++) {
+        RADE_COMP s1 = rade_cmul(fout[m + k], tw[k * fstride]);
+        RADE_COMP s2 = rade_cmul(fout[2 * m + k], tw[2 * k * fstride]);
+        RADE_COMP s3 = rade_cadd(s1, s2);
+        RADE_COMP s0 = rade_cscale(rade_csub(s1, s2), epi3);
+
+        RADE_COMP a = rade_csub(fout[k], rade_cscale(s3, 0.5f));
+        fout[k] = rade_cadd(fout[k], s3);
+        fout[2 * m + k] = rade_cmplx(a.real + s0.imag, a.imag - s0.real);
+        fout[m + k] = rade_cmplx(a.real - s0.imag, a.imag + s0.real);
+    }
+}
+
+static void fft_bfly4(RADE_COMP *fout, int fstride, const rade_fft_cfg *cfg, int m) {
+    const RADE_COMP *tw = cfg->twiddles;
+
+    for (int k = 0; k < m; k++) {
+        RADE_COMP s0 = rade_cmul(fout[m + k], tw[k * fstride]);
+        RADE_COMP s1 = rade_cmul(fout[2 * m + k], tw[2 * k * fstride]);
+        RADE_COMP s2 = rade_cmul(fout[3 * m + k], tw[3 * k * fstride]);
+
+        RADE_COMP s5 = rade_csub(fout[k], s1);
+        RADE_COMP s6 = rade_cadd(fout[k], s1);
+        RADE_COMP s3 = rade_cadd(s0, s2);
+        RADE_COMP s4 = rade_csub(s0, s2);
+
+        fout[k] = rade_cadd(s6, s3);
+        fout[2 * m + k] = rade_csub(s6, s3);
+        if (cfg->inverse) {
+            fout[m + k] = rade_cmplx(s5.real - s4.imag, s5.imag + s4.real);
+            fout[3 * m + k] = rade_cmplx(s5.real + s4.imag, s5.imag - s4.real);
+        } else {
+            fout[m + k] = rade_cmplx(s5.real + s4.imag, s5.imag - s4.real);
+            fout[3 * m + k] = rade_cmplx(s5.real - s4.imag, s5.imag + s4.real);
+        }
+    }
+}
+
+static void fft_bfly5(RADE_COMP *fout, int fstride, const rade_fft_cfg *cfg, int m) {
+    const RADE_COMP *tw = cfg->twiddles;
+    RADE_COMP ya = tw[fstride * m];             /* exp(-/+j*2*pi/5) */
+    RADE_COMP yb = tw[2 * fstride * m];         /* exp(-/+j*4*pi/5) */
+
+    for (int k = 0; k < m; k++) {
+        RADE_COMP s0 = fout[k];
+        RADE_COMP s1 = rade_cmul(fout[m + k], tw[k * fstride]);
+        RADE_COMP s2 = rade_cmul(fout[2 * m + k], tw[2 * k * fstride]);
+        RADE_COMP s3 = rade_cmul(fout[3 * m + k], tw[3 * k * fstride]);
+        RADE_COMP s4 = rade_cmul(fout[4 * m + k], tw[4 * k * fstride]);
+
+        RADE_COMP s7 = rade_cadd(s1, s4);
+        RADE_COMP s10 = rade_csub(s1, s4);
+        RADE_COMP s8 = rade_cadd(s2, s3);
+        RADE_COMP s9 = rade_csub(s2, s3);
+
+        fout[k] = rade_cadd(s0, rade_cadd(s7, s8));
+
+        RADE_COMP s5 = rade_cmplx(s0.real + s7.real * ya.real + s8.real * yb.real,
+                                  s0.imag + s7.imag * ya.real + s8.imag * yb.real);
+        RADE_COMP s6 = rade_cmplx(s10.imag * ya.imag + s9.imag * yb.imag,
+                                  -s10.real * ya.imag - s9.real * yb.imag);
+        fout[m + k] = rade_csub(s5, s6);
+        fout[4 * m + k] = rade_cadd(s5, s6);
+
+        RADE_COMP s11 = rade_cmplx(s0.real + s7.real * yb.real + s8.real * ya.real,
+                                   s0.imag + s7.imag * yb.real + s8.imag * ya.real);
+        RADE_COMP s12 = rade_cmplx(-s10.imag * yb.imag + s9.imag * ya.imag,
+                                   s10.real * yb.imag - s9.real * ya.imag);
+        fout[2 * m + k] = rade_cadd(s11, s12);
+        fout[3 * m + k] = rade_csub(s11, s12);
+    }
+}
+
+/*---------------------------------------------------------------------------*\
+                              PROCESSING
+\*---------------------------------------------------------------------------*/
+
+/* One radix stage: recursively transform the p decimated sub-sequences
+   of length m into consecutive blocks of fout, then combine them */
+static void fft_work(const rade_fft_cfg *cfg, RADE_COMP *fout, const RADE_COMP *fin,
+                     int fstride, const int *factors) {
+    int p = factors[0];
+    int m = factors[1];
+
+    if (m == 1) {
+        for (int q = 0; q < p; q++) {
+            fout[q] = fin[q * fstride];
+        }
+    } else {
+        for (int q = 0; q < p; q++) {
+            fft_work(cfg, &fout[q * m], &fin[q * fstride], fstride * p, factors + 2);
+        }
+    }
+
+    switch (p) {
+    case 2: fft_bfly2(fout, fstride, cfg, m); break;
+    case 3: fft_bfly3(fout, fstride, cfg, m); break;
+    case 4: fft_bfly4(fout, fstride, cfg, m); break;
+    case 5: fft_bfly5(fout, fstride, cfg, m); break;
+    default: assert(0);
+    }
+}
+
+void rade_fft(const rade_fft_cfg *cfg, RADE_COMP *fout, const RADE_COMP *fin) {
+    assert(cfg->nfft > 0);
+    assert(fout != fin);
+    fft_work(cfg, fout, fin, 1, cfg->factors);
+}
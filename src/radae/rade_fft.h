@@ -0,0 +1,90 @@
+/*---------------------------------------------------------------------------*\
+
+  rade_fft.h
+
+  Mixed-radix (2, 3, 4, 5) complex FFT for RADAE C implementation.
+
+\*---------------------------------------------------------------------------*/
+
+/*
+  Copyright (C) 2024 David Rowe
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  - Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE FOUNDATION OR
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef __RADE_FFT__
+#define __RADE_FFT__
+
+#include "rade_dsp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------*\
+                              FFT STATE
+\*---------------------------------------------------------------------------*/
+
+#define RADE_FFT_NMAX           3200    /* Largest supported transform */
+#define RADE_FFT_MAXFACTORS     16      /* Max number of radix stages */
+
+typedef struct {
+    int nfft;                                   /* Transform length */
+    int inverse;                                /* 1 for exp(+j...) kernel */
+    int factors[2 * RADE_FFT_MAXFACTORS];       /* (radix, stride) pairs */
+    RADE_COMP *twiddles;                        /* exp(-/+j*2*pi*k/nfft), nfft of them */
+} rade_fft_cfg;
+
+/*---------------------------------------------------------------------------*\
+                           INITIALIZATION
+\*---------------------------------------------------------------------------*/
+
+/* Initialize FFT configuration
+   nfft: transform length, 2 <= nfft <= RADE_FFT_NMAX with factors 2, 3 and 5 only
+   inverse: 0 for forward transform, 1 for inverse (no 1/nfft scaling either way)
+   cfg must be zeroed, or set up by an earlier call whose twiddle table is
+   then reused.  Returns 0 on success, -1 if nfft is not supported or the
+   table could not be allocated */
+int rade_fft_init(rade_fft_cfg *cfg, int nfft, int inverse);
+
+/* Free the twiddle table, leaving cfg zeroed */
+void rade_fft_close(rade_fft_cfg *cfg);
+
+/*---------------------------------------------------------------------------*\
+                              PROCESSING
+\*---------------------------------------------------------------------------*/
+
+/* Compute FFT
+   fin: input samples [nfft]
+   fout: output bins [nfft], must not alias fin
+
+   Forward:  fout[k] = sum(fin[n] * exp(-j*2*pi*k*n/nfft))
+   Inverse:  fout[n] = sum(fin[k] * exp(+j*2*pi*k*n/nfft)) */
+void rade_fft(const rade_fft_cfg *cfg, RADE_COMP *fout, const RADE_COMP *fin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RADE_FFT__ */
@@ -0,0 +1,127 @@
+/*---------------------------------------------------------------------------*\
+
+  rade_gate.c
+
+  Energy gate that thins out pilot search on dead air.
+
+\*---------------------------------------------------------------------------*/
+
+/*
+  Copyright (C) 2024 David Rowe
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  - Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE FOUNDATION OR
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "rade_gate.h"
+#include <string.h>
+#include <assert.h>
+
+/*---------------------------------------------------------------------------*\
+                           INITIALIZATION
+\*---------------------------------------------------------------------------*/
+
+void rade_gate_init(rade_gate *gate, const rade_ofdm *ofdm) {
+    memset(gate, 0, sizeof(rade_gate));
+
+    gate->period = 1;
+    gate->thresh = RADE_GATE_THRESH;
+    gate->r_floor = -1.0f;
+
+    /* Carriers sit on RADE_M point FFT bins (Rs' = Fs/M) */
+    int ret = rade_fft_init(&gate->fft, RADE_M, 0);
+    assert(ret == 0);
+    (void)ret;
+    gate->k_in_start = (int)roundf(ofdm->w[0] * RADE_M / (2.0f * M_PI));
+    gate->k_in_end = (int)roundf(ofdm->w[RADE_NC - 1] * RADE_M / (2.0f * M_PI));
+
+    /* Reference bands either side, with a guard for the +/- 50 Hz
+       frequency offset and the leakage of unaligned OFDM symbols */
+    gate->k_ref_lo = gate->k_in_start - RADE_GATE_NGUARD - RADE_GATE_NREF;
+    gate->k_ref_hi = gate->k_in_end + RADE_GATE_NGUARD + 1;
+    assert(gate->k_ref_lo >= 0);
+    assert(gate->k_ref_hi + RADE_GATE_NREF <= RADE_M);
+
+    rade_gate_reset(gate);
+}
+
+void rade_gate_close(rade_gate *gate) {
+    rade_fft_close(&gate->fft);
+}
+
+void rade_gate_reset(rade_gate *gate) {
+    gate->count = gate->period;
+}
+
+/*---------------------------------------------------------------------------*\
+                              PROCESSING
+\*---------------------------------------------------------------------------*/
+
+int rade_gate_process(rade_gate *gate, const RADE_COMP *rx, int n) {
+    if (gate->period <= 1) {
+        return 1;
+    }
+
+    /* Mean energy per bin in the carrier and reference bands */
+    float E_in = 0.0f;
+    float E_ref = 0.0f;
+    RADE_COMP X[RADE_M];
+
+    for (int b = 0; b + RADE_M <= n; b += RADE_M) {
+        rade_fft(&gate->fft, X, &rx[b]);
+        for (int k = gate->k_in_start; k <= gate->k_in_end; k++) {
+            E_in += rade_cabs2(X[k]);
+        }
+        for (int k = 0; k < RADE_GATE_NREF; k++) {
+            E_ref += rade_cabs2(X[gate->k_ref_lo + k]) + rade_cabs2(X[gate->k_ref_hi + k]);
+        }
+    }
+    E_in /= gate->k_in_end - gate->k_in_start + 1;
+    E_ref /= 2 * RADE_GATE_NREF;
+
+    /* Digital silence comes out as r = 1, which never opens the gate */
+    float r = (E_in + 1E-12f) / (E_ref + 1E-12f);
+    gate->r = r;
+
+    int open = 0;
+    if (gate->r_floor < 0.0f) {
+        gate->r_floor = r;
+    } else {
+        open = r > gate->thresh * gate->r_floor;
+
+        /* Follow the floor down quickly and up slowly, so it settles
+           just below the typical noise only ratio.  Frames that look like
+           signal barely move it, that only gets us out of a floor stuck
+           low after the noise changes shape */
+        float alpha = (r < gate->r_floor) ? 0.1f : (open ? 0.001f : 0.01f);
+        gate->r_floor += alpha * (r - gate->r_floor);
+    }
+
+    gate->count++;
+    if (open || gate->count >= gate->period) {
+        gate->count = 0;
+        return 1;
+    }
+
+    return 0;
+}
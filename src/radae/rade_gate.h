@@ -0,0 +1,99 @@
+/*---------------------------------------------------------------------------*\
+
+  rade_gate.h
+
+  Energy gate that thins out pilot search on dead air.
+
+\*---------------------------------------------------------------------------*/
+
+/*
+  Copyright (C) 2024 David Rowe
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  - Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE FOUNDATION OR
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef __RADE_GATE__
+#define __RADE_GATE__
+
+#include "rade_dsp.h"
+#include "rade_ofdm.h"
+#include "rade_fft.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------*\
+                              GATE STATE
+\*---------------------------------------------------------------------------*/
+
+/* The gate compares the mean energy of the OFDM carrier bins with two
+   reference bands just outside them.  Noise gives a ratio that depends
+   only on the receiver's filter shape, which is tracked as a floor.  A
+   RADE signal lifts the carrier bins above that floor. */
+typedef struct {
+    int period;                                 /* Max frames between searches while
+                                                   gate closed, <= 1 disables gate */
+    float thresh;                               /* Open when r > thresh * r_floor */
+    int count;                                  /* Frames since the last search */
+    float r;                                    /* Last carrier/reference energy ratio */
+    float r_floor;                              /* Noise floor of r, < 0 until first frame */
+
+    int k_in_start;                             /* First carrier bin */
+    int k_in_end;                               /* Last carrier bin */
+    int k_ref_lo;                               /* First bin of lower reference band */
+    int k_ref_hi;                               /* First bin of upper reference band */
+    rade_fft_cfg fft;                           /* RADE_M point forward FFT */
+} rade_gate;
+
+/*---------------------------------------------------------------------------*\
+                           INITIALIZATION
+\*---------------------------------------------------------------------------*/
+
+/* Initialize gate for the carriers of ofdm, disabled (period = 1).
+   rade_gate_close() a gate before initialising it again */
+void rade_gate_init(rade_gate *gate, const rade_ofdm *ofdm);
+
+/* Free the FFT set up by rade_gate_init() */
+void rade_gate_close(rade_gate *gate);
+
+/* Make the next rade_gate_process() call ask for a search, keeps the
+   noise floor */
+void rade_gate_reset(rade_gate *gate);
+
+/*---------------------------------------------------------------------------*\
+                              PROCESSING
+\*---------------------------------------------------------------------------*/
+
+/* Update the gate with n new samples (a multiple of RADE_M is used)
+   Returns 1 if the full pilot search should run this frame: the gate is
+   open, it is disabled, or period frames have passed since the last search */
+int rade_gate_process(rade_gate *gate, const RADE_COMP *rx, int n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RADE_GATE__ */
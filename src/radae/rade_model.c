@@ -0,0 +1,78 @@
+/*---------------------------------------------------------------------------*\
+
+  rade_model.c
+
+  RADAE encoder and decoder weights, shared by transmitters and receivers.
+
+\*---------------------------------------------------------------------------*/
+
+/*
+  Copyright (C) 2024 David Rowe
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  - Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE FOUNDATION OR
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "rade_model.h"
+#include "rade_dsp.h"
+
+/*---------------------------------------------------------------------------*\
+                              MODEL
+\*---------------------------------------------------------------------------*/
+
+/* The weight file holds encoder and decoder arrays in one list, the
+   built-in weights are one list each */
+static int model_layers_init(rade_model *m, const WeightArray *enc_arrays, const WeightArray *dec_arrays, int dim) {
+    if (init_radeenc(&m->enc[0], enc_arrays, dim) != 0 || init_radedec(&m->dec[0], dec_arrays, dim) != 0) {
+        return -1;
+    }
+    m->enc[1] = m->enc[0];
+    m->dec[1] = m->dec[0];
+    rade_enc_use_int8(&m->enc[1]);
+    rade_dec_use_int8(&m->dec[1]);
+    return 0;
+}
+
+int rade_model_init(rade_model *m, const char *model_file, int auxdata) {
+    memset(m, 0, sizeof(rade_model));
+    int dim = (RADE_NUM_FEATURES + (auxdata ? 1 : 0)) * RADE_FRAMES_PER_STEP;
+
+    /* Anything that isn't a weight file, such as the .pth names of the
+       Python implementation, gets the weights compiled in via
+       rade_enc_data.c and rade_dec_data.c */
+    if (model_file != NULL && rade_weights_open(&m->weights, model_file) == 0) {
+        if (model_layers_init(m, m->weights.arrays, m->weights.arrays, dim) == 0) {
+            return 0;
+        }
+        fprintf(stderr, "rade_model_init: %s doesn't match the model, using built-in weights\n", model_file);
+        rade_weights_close(&m->weights);
+    }
+    return model_layers_init(m, radeenc_arrays, radedec_arrays, dim);
+}
+
+void rade_model_release(rade_model *m) {
+    rade_weights_close(&m->weights);
+}
@@ -0,0 +1,72 @@
+/*---------------------------------------------------------------------------*\
+
+  rade_model.h
+
+  RADAE encoder and decoder weights, shared by transmitters and receivers.
+
+\*---------------------------------------------------------------------------*/
+
+/*
+  Copyright (C) 2024 David Rowe
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  - Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE FOUNDATION OR
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef __RADE_MODEL__
+#define __RADE_MODEL__
+
+#include "rade_enc.h"
+#include "rade_dec.h"
+#include "rade_weights.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------*\
+                              MODEL
+\*---------------------------------------------------------------------------*/
+
+/* Initialised once, then only read: any number of transmitters and
+   receivers, on any threads, point at the same model */
+typedef struct rade_model {
+    rade_weights weights;   /* Weight file the layers point into, if any */
+    RADEEnc enc[2];         /* [0] as loaded, [1] on int8 weights where exported */
+    RADEDec dec[2];
+} rade_model;
+
+/* Load the weights from model_file (a weight file, see rade_weights.h) or,
+   if it's NULL or not a weight file, the built-in weights.  auxdata: 1 for
+   the model with auxiliary data symbols.  Returns 0 on success */
+int rade_model_init(rade_model *m, const char *model_file, int auxdata);
+
+/* Release the weight file, once nothing uses the model */
+void rade_model_release(rade_model *m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RADE_MODEL__ */
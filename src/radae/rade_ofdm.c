@@ -65,24 +65,14 @@ void rade_ofdm_init(rade_ofdm *ofdm, int bottleneck) {
     for (int c = 0; c < Nc; c++) {
         ofdm->w[c] = 2.0f * M_PI * (carrier_1_index + c) / M;
     }
+    assert(carrier_1_index >= 0 && carrier_1_index + Nc <= M);
+    ofdm->k0 = carrier_1_index;
 
-    /* Compute IDFT matrix (Tx): Winv[c][n] = exp(j*w[c]*n) / M
-       freq_in[Nc] * Winv[Nc][M] -> time_out[M] */
-    for (int c = 0; c < Nc; c++) {
-        for (int n = 0; n < M; n++) {
-            float theta = ofdm->w[c] * n;
-            ofdm->Winv[n][c] = rade_cscale(rade_cexp(theta), 1.0f / M);
-        }
-    }
-
-    /* Compute DFT matrix (Rx): Wfwd[n][c] = exp(-j*w[c]*n)
-       time_in[M] * Wfwd[M][Nc] -> freq_out[Nc] */
-    for (int n = 0; n < M; n++) {
-        for (int c = 0; c < Nc; c++) {
-            float theta = -ofdm->w[c] * n;
-            ofdm->Wfwd[c][n] = rade_cexp(theta);
-        }
-    }
+    /* M point FFT, its twiddles are also the direct DFT kernel */
+    ofdm->fft_en = 1;
+    int ret = rade_fft_init(&ofdm->fft, M, 0);
+    assert(ret == 0);
+    (void)ret;
 
     /* Generate pilot symbols */
     rade_barker_pilots(ofdm->P, Nc);
@@ -96,15 +86,9 @@ void rade_ofdm_init(rade_ofdm *ofdm, int bottleneck) {
         ofdm->pilot_gain = 1.0f;
     }
 
-    /* Compute time-domain pilots: p = P * Winv^T */
-    memset(ofdm->p, 0, sizeof(ofdm->p));
-    memset(ofdm->pend, 0, sizeof(ofdm->pend));
-    for (int n = 0; n < M; n++) {
-        for (int c = 0; c < Nc; c++) {
-            ofdm->p[n] = rade_cadd(ofdm->p[n], rade_cmul(ofdm->P[c], ofdm->Winv[n][c]));
-            ofdm->pend[n] = rade_cadd(ofdm->pend[n], rade_cmul(ofdm->Pend[c], ofdm->Winv[n][c]));
-        }
-    }
+    /* Compute time-domain pilots */
+    rade_ofdm_idft(ofdm, ofdm->p, ofdm->P);
+    rade_ofdm_idft(ofdm, ofdm->pend, ofdm->Pend);
 
     /* Compute time-domain pilots with cyclic prefix */
     if (Ncp > 0) {
@@ -160,6 +144,8 @@ void rade_ofdm_init(rade_ofdm *ofdm, int bottleneck) {
         if (c == 0) c_mid = 1;
         if (c == Nc - 1) c_mid = Nc - 2;
 
+        ofdm->Wdelay[c] = rade_cexp(-ofdm->w[c] * a);
+
         /* Build 3x2 matrix A for LS fit */
         /* A = [[1, exp(-j*w[c_mid-1]*a)],
                [1, exp(-j*w[c_mid]*a)],
@@ -204,17 +190,46 @@ void rade_ofdm_init(rade_ofdm *ofdm, int bottleneck) {
     }
 }
 
+void rade_ofdm_close(rade_ofdm *ofdm) {
+    rade_fft_close(&ofdm->fft);
+}
+
 /*---------------------------------------------------------------------------*\
                            MODULATION (TX)
 \*---------------------------------------------------------------------------*/
 
-/* IDFT: freq_in[Nc] -> time_out[M] */
+/* IDFT: freq_in[Nc] -> time_out[M]
+   time_out[n] = sum(freq_in[c] * exp(j*2*pi*(k0+c)*n/M)) / M */
 void rade_ofdm_idft(const rade_ofdm *ofdm, RADE_COMP *time_out, const RADE_COMP *freq_in) {
     int M = ofdm->m;
     int Nc = ofdm->nc;
+    const RADE_COMP *tw = ofdm->fft.twiddles;
+
+    if (ofdm->fft_en) {
+        /* Inverse from the forward FFT: conj(FFT(conj(X))) */
+        RADE_COMP X[RADE_M];
+        RADE_COMP x[RADE_M];
+        memset(X, 0, sizeof(RADE_COMP) * M);
+        for (int c = 0; c < Nc; c++) {
+            X[ofdm->k0 + c] = rade_cconj(freq_in[c]);
+        }
+        rade_fft(&ofdm->fft, x, X);
+        for (int n = 0; n < M; n++) {
+            time_out[n] = rade_cscale(rade_cconj(x[n]), 1.0f / M);
+        }
+        return;
+    }
 
     for (int n = 0; n < M; n++) {
-        time_out[n] = rade_cdot_comp(freq_in, ofdm->Winv[n], Nc);
+        /* tw[i] = exp(-j*2*pi*i/M), i = (k0+c)*n mod M */
+        int i = (ofdm->k0 * n) % M;
+        RADE_COMP acc = rade_czero();
+        for (int c = 0; c < Nc; c++) {
+            acc = rade_cadd(acc, rade_cmul(freq_in[c], rade_cconj(tw[i])));
+            i += n;
+            if (i >= M) i -= M;
+        }
+        time_out[n] = rade_cscale(acc, 1.0f / M);
     }
 }
 
@@ -322,13 +337,74 @@ int rade_ofdm_mod_frame(const rade_ofdm *ofdm, RADE_COMP *tx_out, const float *z
                           DEMODULATION (RX)
 \*---------------------------------------------------------------------------*/
 
-/* DFT: time_in[M] -> freq_out[Nc] */
+/* DFT: time_in[M] -> freq_out[Nc]
+   freq_out[c] = sum(time_in[n] * exp(-j*2*pi*(k0+c)*n/M)) */
 void rade_ofdm_dft(const rade_ofdm *ofdm, RADE_COMP *freq_out, const RADE_COMP *time_in) {
     int M = ofdm->m;
     int Nc = ofdm->nc;
+    const RADE_COMP *tw = ofdm->fft.twiddles;
+
+    if (ofdm->fft_en) {
+        /* All M bins, keep the carriers */
+        RADE_COMP X[RADE_M];
+        rade_fft(&ofdm->fft, X, time_in);
+        memcpy(freq_out, &X[ofdm->k0], sizeof(RADE_COMP) * Nc);
+        return;
+    }
 
     for (int c = 0; c < Nc; c++) {
-        freq_out[c] = rade_cdot_comp(time_in, ofdm->Wfwd[c], M);
+        int k = ofdm->k0 + c;
+        int i = 0;
+        RADE_COMP acc = rade_czero();
+        for (int n = 0; n < M; n++) {
+            acc = rade_cadd(acc, rade_cmul(time_in[n], tw[i]));
+            i += k;
+            if (i >= M) i -= M;
+        }
+        freq_out[c] = acc;
+    }
+}
+
+/* DFT all symbols of a modem frame: rx_in[nmf+m+ncp] -> rx_sym[ns+2][nc] */
+void rade_ofdm_dft_frame(const rade_ofdm *ofdm, RADE_COMP *rx_sym, const RADE_COMP *rx_in,
+                         int time_offset) {
+    int M = ofdm->m;
+    int Nc = ofdm->nc;
+    int Nsym = ofdm->ns + 2;
+    int Nsym_samples = M + ofdm->ncp;
+    const RADE_COMP *tw = ofdm->fft.twiddles;
+
+    /* First sample of symbol s is x[s * Nsym_samples] */
+    const RADE_COMP *x = &rx_in[ofdm->ncp + time_offset];
+
+    if (ofdm->fft_en) {
+        RADE_COMP X[RADE_M];
+        for (int s = 0; s < Nsym; s++) {
+            rade_fft(&ofdm->fft, X, &x[s * Nsym_samples]);
+            memcpy(&rx_sym[s * Nc], &X[ofdm->k0], sizeof(RADE_COMP) * Nc);
+        }
+        return;
+    }
+
+    /* One row of the DFT matrix at a time, against every symbol */
+    for (int c = 0; c < Nc; c++) {
+        int k = ofdm->k0 + c;
+        int i = 0;
+        RADE_COMP acc[RADE_NS + 2];
+        for (int s = 0; s < Nsym; s++) {
+            acc[s] = rade_czero();
+        }
+        for (int n = 0; n < M; n++) {
+            RADE_COMP w = tw[i];
+            for (int s = 0; s < Nsym; s++) {
+                acc[s] = rade_cadd(acc[s], rade_cmul(x[s * Nsym_samples + n], w));
+            }
+            i += k;
+            if (i >= M) i -= M;
+        }
+        for (int s = 0; s < Nsym; s++) {
+            rx_sym[s * Nc + c] = acc[s];
+        }
     }
 }
 
@@ -348,63 +424,65 @@ void rade_ofdm_remove_cp(const rade_ofdm *ofdm, RADE_COMP *time_out, const RADE_
 void rade_ofdm_est_pilots(const rade_ofdm *ofdm, RADE_COMP *pilot_est,
                           const RADE_COMP *rx_pilots, int num_pilots) {
     int Nc = ofdm->nc;
-    float Fs = (float)RADE_FS;
-    float a = ofdm->local_path_delay_s * Fs;
 
     for (int p = 0; p < num_pilots; p++) {
         const RADE_COMP *rx_p = &rx_pilots[p * Nc];
         RADE_COMP *est_p = &pilot_est[p * Nc];
 
+        /* h = rx_p / P, each carrier is used by up to three fits */
+        RADE_COMP h[RADE_NC];
+        for (int c = 0; c < Nc; c++) {
+            h[c] = rade_cdiv(rx_p[c], ofdm->P[c]);
+        }
+
         for (int c = 0; c < Nc; c++) {
             int c_mid = c;
             if (c == 0) c_mid = 1;
             if (c == Nc - 1) c_mid = Nc - 2;
 
-            /* h = rx_p / P (element-wise for 3 neighboring carriers) */
-            RADE_COMP h[3];
-            for (int i = 0; i < 3; i++) {
-                h[i] = rade_cdiv(rx_p[c_mid - 1 + i], ofdm->P[c_mid - 1 + i]);
-            }
-
             /* g = Pmat * h (2x3 * 3x1 = 2x1) */
             RADE_COMP g[2];
             for (int i = 0; i < 2; i++) {
                 g[i] = rade_czero();
                 for (int j = 0; j < 3; j++) {
-                    g[i] = rade_cadd(g[i], rade_cmul(ofdm->Pmat[c][i][j], h[j]));
+                    g[i] = rade_cadd(g[i], rade_cmul(ofdm->Pmat[c][i][j], h[c_mid - 1 + j]));
                 }
             }
 
             /* Channel estimate at carrier c: h_c = g[0] + g[1]*exp(-j*w[c]*a) */
-            est_p[c] = rade_cadd(g[0], rade_cmul(g[1], rade_cexp(-ofdm->w[c] * a)));
+            est_p[c] = rade_cadd(g[0], rade_cmul(g[1], ofdm->Wdelay[c]));
         }
     }
 }
 
-/* Equalize data symbols using pilot estimates */
-float rade_ofdm_pilot_eq(const rade_ofdm *ofdm, RADE_COMP *rx_sym,
-                         const RADE_COMP *rx_pilots_start,
-                         const RADE_COMP *pilot_est_start, const RADE_COMP *pilot_est_end,
-                         int coarse_mag) {
+/* exp(-j*angle(h)) without the trig: conj(h)/|h|, 1 for h = 0 as
+   atan2f(0, 0) = 0 gives */
+static inline RADE_COMP ofdm_unrotate(RADE_COMP h) {
+    float mag = rade_cabs(h);
+    if (mag == 0.0f) {
+        return rade_cone();
+    }
+    return rade_cscale(rade_cconj(h), 1.0f / mag);
+}
+
+/* SNR estimate (dB in 3 kHz) from the first pilot
+   Matches Python: update_snr_est() in radae/dsp.py lines 438-444
+   S1 = signal power from received pilot symbols
+   S2 = noise power from phase-corrected received pilots */
+static float ofdm_snr_est(const rade_ofdm *ofdm, const RADE_COMP *rx_pilots_start,
+                          const RADE_COMP *pilot_est_start) {
     int Nc = ofdm->nc;
-    int Ns = ofdm->ns;
     int M = ofdm->m;
     int Ncp = ofdm->ncp;
 
-    /* Compute SNR estimate from first pilot
-       Matches Python: update_snr_est() in radae/dsp.py lines 438-444
-       S1 = signal power from received pilot symbols
-       S2 = noise power from phase-corrected received pilots */
     float S1 = 0.0f, S2 = 0.0f;
     for (int c = 0; c < Nc; c++) {
         /* S1: signal power from received pilot symbols (not channel estimate!) */
-        float mag2 = rade_cabs2(rx_pilots_start[c]);
-        S1 += mag2;
+        S1 += rade_cabs2(rx_pilots_start[c]);
 
-        /* S2: noise estimate from phase-corrected received pilots
-           Use phase from channel estimate to correct received pilots */
-        float rx_phase = rade_cangle(pilot_est_start[c]);
-        RADE_COMP Rcn_hat = rade_cmul(rx_pilots_start[c], rade_cexp(-rx_phase));
+        /* S2: noise estimate from received pilots with the phase of the
+           channel estimate removed */
+        RADE_COMP Rcn_hat = rade_cmul(rx_pilots_start[c], ofdm_unrotate(pilot_est_start[c]));
         S2 += Rcn_hat.imag * Rcn_hat.imag;
     }
     S2 += 1e-12f;  /* Avoid division by zero */
@@ -419,25 +497,22 @@ float rade_ofdm_pilot_eq(const rade_ofdm *ofdm, RADE_COMP *rx_sym,
 
     /* Convert to 3kHz noise bandwidth */
     float Rs = (float)RADE_FS / M;
-    float snrdB_3k = snrdB_est + 10.0f * log10f(Rs * Nc / 3000.0f) +
-                     10.0f * log10f((float)(M + Ncp) / M);
-
-    /* Linearly interpolate channel estimate between pilots and equalize */
-    for (int s = 0; s < Ns; s++) {
-        /* Interpolation factor: pilot at 0, data at 1..Ns, pilot at Ns+1 */
-        float t = (float)(s + 1) / (float)(Ns + 1);
-
-        for (int c = 0; c < Nc; c++) {
-            /* Interpolated channel estimate */
-            RADE_COMP ch_est = rade_clerp(pilot_est_start[c], pilot_est_end[c], t);
+    return snrdB_est + 10.0f * log10f(Rs * Nc / 3000.0f) +
+           10.0f * log10f((float)(M + Ncp) / M);
+}
 
-            /* Phase correction only */
-            float ch_angle = rade_cangle(ch_est);
-            rx_sym[s * Nc + c] = rade_cmul(rx_sym[s * Nc + c], rade_cexp(-ch_angle));
-        }
-    }
+/* Equalize data symbols rx_sym[ns][nc] to interleaved re/im floats
+   z_out[ns*nc*2]: phase from the channel estimate interpolated between the
+   pilots and, with coarse_mag, a single gain from the pilot magnitudes.
+   Both fold into one complex coefficient per symbol */
+static void ofdm_eq(const rade_ofdm *ofdm, float *z_out, const RADE_COMP *rx_sym,
+                    const RADE_COMP *pilot_est_start, const RADE_COMP *pilot_est_end,
+                    int coarse_mag) {
+    int Nc = ofdm->nc;
+    int Ns = ofdm->ns;
 
     /* Coarse magnitude correction */
+    float inv_mag = 1.0f;
     if (coarse_mag) {
         float mag_sum = 0.0f;
         for (int c = 0; c < Nc; c++) {
@@ -448,70 +523,68 @@ float rade_ofdm_pilot_eq(const rade_ofdm *ofdm, RADE_COMP *rx_sym,
         if (ofdm->bottleneck == 3) {
             mag = mag * rade_cabs(ofdm->P[0]) / ofdm->pilot_gain;
         }
+        inv_mag = 1.0f / mag;
+    }
 
-        float inv_mag = 1.0f / mag;
-        for (int s = 0; s < Ns; s++) {
-            for (int c = 0; c < Nc; c++) {
-                rx_sym[s * Nc + c] = rade_cscale(rx_sym[s * Nc + c], inv_mag);
-            }
+    /* Linearly interpolate channel estimate between pilots and equalize */
+    for (int s = 0; s < Ns; s++) {
+        /* Interpolation factor: pilot at 0, data at 1..Ns, pilot at Ns+1 */
+        float t = (float)(s + 1) / (float)(Ns + 1);
+        const RADE_COMP *sym = &rx_sym[s * Nc];
+        float *z = &z_out[2 * s * Nc];
+
+        for (int c = 0; c < Nc; c++) {
+            RADE_COMP ch_est = rade_clerp(pilot_est_start[c], pilot_est_end[c], t);
+            RADE_COMP g = rade_cscale(ofdm_unrotate(ch_est), inv_mag);
+            RADE_COMP y = rade_cmul(sym[c], g);
+            z[2 * c] = y.real;
+            z[2 * c + 1] = y.imag;
         }
     }
+}
+
+/* Equalize data symbols using pilot estimates */
+float rade_ofdm_pilot_eq(const rade_ofdm *ofdm, RADE_COMP *rx_sym,
+                         const RADE_COMP *rx_pilots_start,
+                         const RADE_COMP *pilot_est_start, const RADE_COMP *pilot_est_end,
+                         int coarse_mag) {
+    int Nc = ofdm->nc;
+    int Ns = ofdm->ns;
+
+    float z[RADE_NS * RADE_NC * 2];
+    ofdm_eq(ofdm, z, rx_sym, pilot_est_start, pilot_est_end, coarse_mag);
+    for (int i = 0; i < Ns * Nc; i++) {
+        rx_sym[i] = rade_cmplx(z[2 * i], z[2 * i + 1]);
+    }
 
-    return snrdB_3k;
+    return ofdm_snr_est(ofdm, rx_pilots_start, pilot_est_start);
 }
 
 /* Demodulate one modem frame */
 int rade_ofdm_demod_frame(const rade_ofdm *ofdm, float *z_hat, const RADE_COMP *rx_in,
                           int time_offset, int endofover, int coarse_mag, float *snr_est) {
     int Nc = ofdm->nc;
-    int M = ofdm->m;
-    int Ncp = ofdm->ncp;
     int Ns = ofdm->ns;
 
-    /* Buffer for received symbols: pilot + Ns data + pilot = Ns+2 symbols */
-    RADE_COMP rx_sym[(RADE_NS + 2)][RADE_NC];
-    RADE_COMP time_buf[RADE_M];
-
-    /* Demodulate all symbols in frame */
-    for (int s = 0; s < Ns + 2; s++) {
-        int sample_offset = s * (M + Ncp);
-        rade_ofdm_remove_cp(ofdm, time_buf, &rx_in[sample_offset], time_offset);
-        rade_ofdm_dft(ofdm, rx_sym[s], time_buf);
+    if (endofover) {
+        /* EOO frame - use simpler equalization */
+        return rade_ofdm_demod_eoo(ofdm, z_hat, rx_in, time_offset);
     }
 
-    if (!endofover) {
-        /* Normal frame: estimate pilots and equalize */
-        RADE_COMP pilot_est[2][RADE_NC];
-
-        /* First pilot at symbol 0, second at symbol Ns+1 */
-        RADE_COMP rx_pilots[2 * RADE_NC];
-        memcpy(&rx_pilots[0], rx_sym[0], sizeof(RADE_COMP) * Nc);
-        memcpy(&rx_pilots[Nc], rx_sym[Ns + 1], sizeof(RADE_COMP) * Nc);
-
-        rade_ofdm_est_pilots(ofdm, (RADE_COMP*)pilot_est, rx_pilots, 2);
+    /* Received symbols: pilot, Ns data, pilot */
+    RADE_COMP rx_sym[(RADE_NS + 2)][RADE_NC];
+    rade_ofdm_dft_frame(ofdm, &rx_sym[0][0], rx_in, time_offset);
 
-        /* Equalize data symbols (symbols 1 to Ns) */
-        RADE_COMP rx_data[RADE_NS * RADE_NC];
-        for (int s = 0; s < Ns; s++) {
-            memcpy(&rx_data[s * Nc], rx_sym[s + 1], sizeof(RADE_COMP) * Nc);
-        }
+    /* First pilot at symbol 0, second at symbol Ns+1 */
+    RADE_COMP pilot_est[2][RADE_NC];
+    rade_ofdm_est_pilots(ofdm, pilot_est[0], rx_sym[0], 1);
+    rade_ofdm_est_pilots(ofdm, pilot_est[1], rx_sym[Ns + 1], 1);
 
-        *snr_est = rade_ofdm_pilot_eq(ofdm, rx_data, &rx_pilots[0], pilot_est[0], pilot_est[1], coarse_mag);
+    /* Equalize data symbols (symbols 1 to Ns) straight into latent floats */
+    *snr_est = ofdm_snr_est(ofdm, rx_sym[0], pilot_est[0]);
+    ofdm_eq(ofdm, z_hat, rx_sym[1], pilot_est[0], pilot_est[1], coarse_mag);
 
-        /* Demap QPSK to latent floats */
-        int out_idx = 0;
-        for (int s = 0; s < Ns; s++) {
-            for (int c = 0; c < Nc; c++) {
-                z_hat[out_idx++] = rx_data[s * Nc + c].real;
-                z_hat[out_idx++] = rx_data[s * Nc + c].imag;
-            }
-        }
-
-        return out_idx;
-    } else {
-        /* EOO frame - use simpler equalization */
-        return rade_ofdm_demod_eoo(ofdm, z_hat, rx_in, time_offset);
-    }
+    return Ns * Nc * 2;
 }
 
 /* Get EOO frame */
@@ -523,20 +596,12 @@ const RADE_COMP* rade_ofdm_get_eoo(const rade_ofdm *ofdm, int *n_out) {
 /* Demodulate EOO frame */
 int rade_ofdm_demod_eoo(const rade_ofdm *ofdm, float *z_hat, const RADE_COMP *rx_in, int time_offset) {
     int Nc = ofdm->nc;
-    int M = ofdm->m;
-    int Ncp = ofdm->ncp;
     int Ns = ofdm->ns;
 
     /* EOO frame structure: P E 0 0 0 E
        Demodulate all Ns+2 symbols */
     RADE_COMP rx_sym[(RADE_NS + 2)][RADE_NC];
-    RADE_COMP time_buf[RADE_M];
-
-    for (int s = 0; s < Ns + 2; s++) {
-        int sample_offset = s * (M + Ncp);
-        rade_ofdm_remove_cp(ofdm, time_buf, &rx_in[sample_offset], time_offset);
-        rade_ofdm_dft(ofdm, rx_sym[s], time_buf);
-    }
+    rade_ofdm_dft_frame(ofdm, &rx_sym[0][0], rx_in, time_offset);
 
     /* Simpler EQ: average phase from P, E1, E2 pilots */
     for (int c = 0; c < Nc; c++) {
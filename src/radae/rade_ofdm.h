@@ -38,6 +38,7 @@
 #define __RADE_OFDM__
 
 #include "rade_dsp.h"
+#include "rade_fft.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -55,9 +56,13 @@ typedef struct {
     int ns;                                     /* Data symbols per modem frame */
     int bottleneck;                             /* Bottleneck mode (1, 2, or 3) */
 
-    /* DFT matrices - pre-computed at init */
-    RADE_COMP Winv[RADE_M][RADE_NC];           /* IDFT matrix (Tx): Nc freq -> M time */
-    RADE_COMP Wfwd[RADE_NC][RADE_M];           /* DFT matrix (Rx): M time -> Nc freq */
+    /* DFT: carrier c is bin k0 + c of an M point DFT.  With fft_en the
+       DFT/IDFT run as an M point FFT (160 = 4*4*2*5), otherwise directly
+       over the Nc carriers.  Either way the FFT twiddles are the
+       exp(-j*2*pi*k/M) table */
+    int k0;                                     /* DFT bin of first carrier */
+    int fft_en;
+    rade_fft_cfg fft;                           /* Forward M point FFT */
 
     /* Carrier frequencies */
     float w[RADE_NC];                           /* Angular frequency per carrier */
@@ -78,6 +83,7 @@ typedef struct {
     /* Equalization matrices - pre-computed at init */
     /* For 3-pilot least-squares fit: Pmat[c] = (A^H A)^-1 A^H */
     RADE_COMP Pmat[RADE_NC][2][3];              /* Per-carrier EQ matrices */
+    RADE_COMP Wdelay[RADE_NC];                  /* exp(-j*w[c]*a), a the path delay */
     float local_path_delay_s;                   /* Assumed path delay for LS EQ */
 
 } rade_ofdm;
@@ -87,12 +93,17 @@ typedef struct {
 \*---------------------------------------------------------------------------*/
 
 /* Initialize OFDM state with default parameters
-   - Computes DFT matrices
+   - Sets up the M point FFT (fft_en, may be cleared afterwards for the
+     direct DFT)
    - Generates pilot symbols
    - Pre-computes EOO frame
-   - Pre-computes equalization matrices */
+   - Pre-computes equalization matrices
+   ofdm must be zeroed, or set up by an earlier rade_ofdm_init() */
 void rade_ofdm_init(rade_ofdm *ofdm, int bottleneck);
 
+/* Free the FFT set up by rade_ofdm_init() */
+void rade_ofdm_close(rade_ofdm *ofdm);
+
 /*---------------------------------------------------------------------------*\
                            MODULATION (TX)
 \*---------------------------------------------------------------------------*/
@@ -118,6 +129,13 @@ int rade_ofdm_mod_frame(const rade_ofdm *ofdm, RADE_COMP *tx_out, const float *z
    time_in[m], freq_out[nc] */
 void rade_ofdm_dft(const rade_ofdm *ofdm, RADE_COMP *freq_out, const RADE_COMP *time_in);
 
+/* DFT every symbol of a modem frame, reading straight past the cyclic
+   prefixes: rx_in[nmf+m+ncp] -> rx_sym[ns+2][nc], one row per symbol.
+   The direct path (fft_en clear) is the Nc x M DFT matrix times the
+   M x (ns+2) matrix of symbols, each twiddle used for all symbols at once */
+void rade_ofdm_dft_frame(const rade_ofdm *ofdm, RADE_COMP *rx_sym, const RADE_COMP *rx_in,
+                         int time_offset);
+
 /* Remove cyclic prefix: M+Ncp samples -> M samples
    time_in[m+ncp], time_out[m], time_offset for fine timing adjustment */
 void rade_ofdm_remove_cp(const rade_ofdm *ofdm, RADE_COMP *time_out, const RADE_COMP *time_in, int time_offset);
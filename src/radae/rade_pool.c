@@ -0,0 +1,171 @@
+/*---------------------------------------------------------------------------*\
+
+  rade_pool.c
+
+  Small fixed size worker pool for RADAE C implementation.
+
+\*---------------------------------------------------------------------------*/
+
+/*
+  Copyright (C) 2024 David Rowe
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  - Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE FOUNDATION OR
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "rade_pool.h"
+#include <string.h>
+#include <assert.h>
+
+/*---------------------------------------------------------------------------*\
+                           INITIALIZATION
+\*---------------------------------------------------------------------------*/
+
+static void *pool_worker(void *arg) {
+    rade_pool_worker *worker = (rade_pool_worker *)arg;
+    rade_pool *pool = worker->pool;
+    unsigned int generation = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->quit && pool->generation == generation) {
+            pthread_cond_wait(&pool->start, &pool->mutex);
+        }
+        if (pool->quit) {
+            break;
+        }
+        generation = pool->generation;
+        rade_pool_fn fn = pool->fn;
+        void *fn_arg = pool->arg;
+        pthread_mutex_unlock(&pool->mutex);
+
+        fn(fn_arg, worker->part, pool->nthreads);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+int rade_pool_init(rade_pool *pool, int nthreads) {
+    memset(pool, 0, sizeof(rade_pool));
+    pool->nthreads = 1;
+
+    if (nthreads < 1 || nthreads > RADE_POOL_MAXTHREADS) {
+        return -1;
+    }
+    if (nthreads == 1) {
+        return 0;
+    }
+
+    if (pthread_mutex_init(&pool->mutex, NULL) != 0) {
+        return -1;
+    }
+    if (pthread_cond_init(&pool->start, NULL) != 0) {
+        pthread_mutex_destroy(&pool->mutex);
+        return -1;
+    }
+    if (pthread_cond_init(&pool->done, NULL) != 0) {
+        pthread_cond_destroy(&pool->start);
+        pthread_mutex_destroy(&pool->mutex);
+        return -1;
+    }
+
+    /* Workers read nthreads, so set it before any start */
+    pool->nthreads = nthreads;
+    for (int i = 1; i < nthreads; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].part = i;
+        if (pthread_create(&pool->threads[i], NULL, pool_worker, &pool->workers[i]) != 0) {
+            /* Stop the ones we did start */
+            pthread_mutex_lock(&pool->mutex);
+            pool->quit = 1;
+            pthread_cond_broadcast(&pool->start);
+            pthread_mutex_unlock(&pool->mutex);
+            for (int j = 1; j < i; j++) {
+                pthread_join(pool->threads[j], NULL);
+            }
+            pthread_cond_destroy(&pool->done);
+            pthread_cond_destroy(&pool->start);
+            pthread_mutex_destroy(&pool->mutex);
+            pool->nthreads = 1;
+            pool->quit = 0;
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+void rade_pool_close(rade_pool *pool) {
+    if (pool->nthreads <= 1) {
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->quit = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 1; i < pool->nthreads; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->start);
+    pthread_mutex_destroy(&pool->mutex);
+    pool->nthreads = 1;
+    pool->quit = 0;
+}
+
+/*---------------------------------------------------------------------------*\
+                              PROCESSING
+\*---------------------------------------------------------------------------*/
+
+void rade_pool_run(rade_pool *pool, rade_pool_fn fn, void *arg) {
+    if (pool->nthreads <= 1) {
+        fn(arg, 0, 1);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    assert(pool->pending == 0);
+    pool->fn = fn;
+    pool->arg = arg;
+    pool->pending = pool->nthreads - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->mutex);
+
+    fn(arg, 0, pool->nthreads);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
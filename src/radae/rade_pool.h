@@ -0,0 +1,101 @@
+/*---------------------------------------------------------------------------*\
+
+  rade_pool.h
+
+  Small fixed size worker pool for RADAE C implementation.
+
+\*---------------------------------------------------------------------------*/
+
+/*
+  Copyright (C) 2024 David Rowe
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  - Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE FOUNDATION OR
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef __RADE_POOL__
+#define __RADE_POOL__
+
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------*\
+                              POOL STATE
+\*---------------------------------------------------------------------------*/
+
+#define RADE_POOL_MAXTHREADS    8       /* Including the calling thread */
+
+/* Job function, called once for each part = 0..nparts-1, each call on a
+   different thread.  Part 0 always runs on the thread calling
+   rade_pool_run() */
+typedef void (*rade_pool_fn)(void *arg, int part, int nparts);
+
+struct rade_pool;
+
+typedef struct {
+    struct rade_pool *pool;
+    int part;
+} rade_pool_worker;
+
+typedef struct rade_pool {
+    int nthreads;                               /* 1 = no worker threads */
+    pthread_t threads[RADE_POOL_MAXTHREADS];
+    rade_pool_worker workers[RADE_POOL_MAXTHREADS];
+    pthread_mutex_t mutex;
+    pthread_cond_t start;                       /* New job posted, or quit */
+    pthread_cond_t done;                        /* A worker finished its part */
+    unsigned int generation;                    /* Bumped for every job */
+    int pending;                                /* Workers still busy on this job */
+    int quit;
+    rade_pool_fn fn;
+    void *arg;
+} rade_pool;
+
+/*---------------------------------------------------------------------------*\
+                           INITIALIZATION
+\*---------------------------------------------------------------------------*/
+
+/* Start nthreads - 1 worker threads, 1 <= nthreads <= RADE_POOL_MAXTHREADS.
+   nthreads = 1 starts nothing and rade_pool_run() calls fn directly.
+   Returns 0 on success, -1 on failure (pool left with nthreads = 1) */
+int rade_pool_init(rade_pool *pool, int nthreads);
+
+/* Stop and join any worker threads, pool is left with nthreads = 1 */
+void rade_pool_close(rade_pool *pool);
+
+/*---------------------------------------------------------------------------*\
+                              PROCESSING
+\*---------------------------------------------------------------------------*/
+
+/* Run fn(arg, part, nthreads) for every part, returns when all are done */
+void rade_pool_run(rade_pool *pool, rade_pool_fn fn, void *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RADE_POOL__ */
@@ -43,7 +43,20 @@
                            INITIALIZATION
 \*---------------------------------------------------------------------------*/
 
-int rade_rx_init(rade_rx_state *rx, const RADEDec *dec_model, int bottleneck, int auxdata, int bpf_en) {
+/* Rx BPF wide enough to pass signals anywhere in the frequency search
+   range frange (Hz) */
+static void rx_bpf_init(rade_rx_state *rx, float frange) {
+    float w_min = rx->ofdm.w[0];
+    float w_max = rx->ofdm.w[RADE_NC - 1];
+    float bandwidth = 1.2f * (w_max - w_min) * RADE_FS / (2.0f * M_PI);
+    float centre = (w_max + w_min) * RADE_FS / (2.0f * M_PI) / 2.0f;
+    if (frange > RADE_ACQ_FRANGE) {
+        bandwidth += frange - RADE_ACQ_FRANGE;
+    }
+    rade_bpf_init(&rx->bpf, RADE_BPF_NTAP, RADE_FS, bandwidth, centre, RADE_FS);
+}
+
+int rade_rx_init(rade_rx_state *rx, const rade_model *model, int bottleneck, int auxdata, int bpf_en) {
     memset(rx, 0, sizeof(rade_rx_state));
 
     rx->bottleneck = bottleneck;
@@ -58,37 +71,33 @@ int rade_rx_init(rade_rx_state *rx, const RADEDec *dec_model, int bottleneck, in
     rade_ofdm_init(&rx->ofdm, bottleneck);
 
     /* Initialize acquisition */
-    rade_acq_init(&rx->acq, &rx->ofdm, RADE_ACQ_FRANGE, RADE_ACQ_FSTEP);
-
-    /* Initialize decoder if model provided */
-    if (dec_model != NULL) {
-        memcpy(&rx->dec_model, dec_model, sizeof(RADEDec));
-    } else {
-        /* Use built-in weights */
-        int output_dim = rx->num_features * RADE_FRAMES_PER_STEP;
-        if (init_radedec(&rx->dec_model, radedec_arrays, output_dim) != 0) {
-            return -1;
-        }
+    rx->frange = RADE_ACQ_FRANGE;
+    rade_acq_init(&rx->acq, &rx->ofdm, rx->frange, RADE_ACQ_FSTEP);
+    rade_gate_init(&rx->gate, &rx->ofdm);
+    rx->gate_period = rx->gate.period;
+
+    /* Initialize decoder, on the weights as loaded */
+    if (model == NULL) {
+        return -1;
     }
+    rx->model = model;
+    rx->dec_model = &model->dec[0];
     rade_init_decoder(&rx->dec_state);
 
     /* Initialize Rx BPF if enabled */
     if (bpf_en) {
-        float w_min = rx->ofdm.w[0];
-        float w_max = rx->ofdm.w[RADE_NC - 1];
-        float bandwidth = 1.2f * (w_max - w_min) * RADE_FS / (2.0f * M_PI);
-        float centre = (w_max + w_min) * RADE_FS / (2.0f * M_PI) / 2.0f;
-        rade_bpf_init(&rx->bpf, RADE_BPF_NTAP, RADE_FS, bandwidth, centre, RADE_FS);
+        rx_bpf_init(rx, RADE_ACQ_FRANGE);
     }
 
     /* Initialize state machine */
     rx->state = RADE_STATE_SEARCH;
     rx->nin = RADE_NMF;
     rx->mf = 1;
-    rx->rx_phase = rade_cone();
+    rade_nco_init(&rx->nco, 0.0f);
 
     /* Calculate unsync timeout (modem frames) */
     rx->Nmf_unsync = (int)(RADE_TUNSYNC * RADE_FS / RADE_NMF);
+    rx->Nmf_lost = (int)(RADE_TLOST * RADE_FS / RADE_NMF);
     rx->synced_count_one_sec = RADE_FS / RADE_NMF;
 
     /* Clear receive buffer */
@@ -97,25 +106,98 @@ int rade_rx_init(rade_rx_state *rx, const RADEDec *dec_model, int bottleneck, in
     return 0;
 }
 
+int rade_rx_set_nn_int8(rade_rx_state *rx, int enable) {
+    const RADEDec *dec_model = &rx->model->dec[enable ? 1 : 0];
+    if ((rade_dec_int8_layers(dec_model) > 0) != (enable != 0)) {
+        return -1;
+    }
+    rx->dec_model = dec_model;
+    return 0;
+}
+
+void rade_rx_close(rade_rx_state *rx) {
+    rade_ofdm_close(&rx->ofdm);
+    rade_acq_close(&rx->acq);
+    rade_gate_close(&rx->gate);
+    rade_bpf_close(&rx->bpf);
+}
+
 void rade_rx_reset(rade_rx_state *rx) {
     rx->state = RADE_STATE_SEARCH;
     rx->nin = RADE_NMF;
     rx->valid_count = 0;
+    rx->lost_count = 0;
     rx->synced_count = 0;
     rx->uw_errors = 0;
-    rx->rx_phase = rade_cone();
+    rade_nco_init(&rx->nco, 0.0f);
     rx->snrdB_3k_est = 0.0f;
     rade_init_decoder(&rx->dec_state);
     if (rx->bpf_en) {
         rade_bpf_reset(&rx->bpf);
     }
     memset(rx->rx_buf, 0, sizeof(rx->rx_buf));
+    rade_acq_reset(&rx->acq);
+    rade_gate_reset(&rx->gate);
+}
+
+int rade_rx_set_frange(rade_rx_state *rx, float frange) {
+    if (rade_acq_set_frange(&rx->acq, frange) != 0) {
+        return -1;
+    }
+    if (rx->bpf_en) {
+        rx_bpf_init(rx, frange);
+    }
+    rx->frange = frange;
+    rade_rx_set_search_gate(rx, rx->gate_period);
+    rade_rx_reset(rx);
+    return 0;
+}
+
+void rade_rx_set_search_gate(rade_rx_state *rx, int period) {
+    /* A station off tuned by more than the default range would sit in the
+       reference bands, and be searched for only every period frames */
+    rx->gate_period = period;
+    rx->gate.period = (rx->frange > RADE_ACQ_FRANGE) ? 1 : period;
+    rade_gate_reset(&rx->gate);
 }
 
 /*---------------------------------------------------------------------------*\
                            RECEPTION
 \*---------------------------------------------------------------------------*/
 
+/* Follow every peak over the threshold from the last search, in case the
+   strongest was noise */
+static void rx_start_candidates(rade_rx_state *rx) {
+    assert(rx->acq.n_cand > 0);
+    rx->n_candidate = rx->acq.n_cand;
+    for (int i = 0; i < rx->n_candidate; i++) {
+        rx->tmax_candidate[i] = rx->acq.cand[i].t;
+        rx->fmax_candidate[i] = rx->acq.cand[i].f;
+        rx->valid_candidate[i] = 1;
+    }
+    rx->valid_count = 1;
+}
+
+/* Pilots confirmed at rx->tmax/fmax: start decoding from there */
+static void rx_enter_sync(rade_rx_state *rx) {
+    rade_init_decoder(&rx->dec_state);  /* Reset decoder state */
+    rx->synced_count = 0;
+    rx->uw_errors = 0;
+    rx->valid_count = rx->Nmf_unsync;
+
+    /* Fine refinement of timing/frequency */
+    float ffine_start = rx->fmax - 10.0f;
+    float ffine_end = rx->fmax + 10.0f;
+    int tfine_start = (rx->tmax > 1) ? (rx->tmax - 1) : 0;
+    int tfine_end = rx->tmax + 2;
+
+    rade_acq_refine(&rx->acq, rx->rx_buf, &rx->tmax, &rx->fmax,
+                   tfine_start, tfine_end, ffine_start, ffine_end, 0.25f);
+
+    rx->tmax_lock = rx->tmax;
+    rx->fmax_lock = rx->fmax;
+}
+
 int rade_rx_nin(const rade_rx_state *rx) {
     return rx->nin;
 }
@@ -148,16 +230,33 @@ void rade_rx_sum_uw_errors(rade_rx_state *rx, int new_uw_errors) {
     rx->uw_errors += new_uw_errors;
 }
 
-int rade_rx_process(rade_rx_state *rx, float *features_out, float *eoo_out, const RADE_COMP *rx_in) {
+/* One modem frame on its way through the receiver.  The front end (BPF,
+   acquisition, demodulation) fills it in, the decoder then runs on z_hat,
+   alone or batched with other receivers, and the state machine finishes
+   the frame */
+typedef struct {
+    int prev_state;
+    int candidate;
+    int endofover;
+    int uw_fail;
+    int searched;
+    int valid_output;
+    int tmax_cand[RADE_ACQ_TOPK];
+    float fmax_cand[RADE_ACQ_TOPK];
+    int valid_cand[RADE_ACQ_TOPK];
+    float z_hat[RADE_NZMF * RADE_LATENT_DIM];   /* Latents to decode if valid_output */
+} rx_frame;
+
+static void rx_front(rade_rx_state *rx, rx_frame *fr, float *eoo_out, const RADE_COMP *rx_in) {
     int M = RADE_M;
     int Ncp = RADE_NCP;
     int Nmf = RADE_NMF;
     float Fs = (float)RADE_FS;
 
-    int prev_state = rx->state;
     int valid_output = 0;
     int endofover = 0;
     int uw_fail = 0;
+    fr->prev_state = rx->state;
 
     /* Apply BPF if enabled */
     RADE_COMP rx_filtered[RADE_NMF + RADE_M];
@@ -172,24 +271,62 @@ int rade_rx_process(rade_rx_state *rx, float *features_out, float *eoo_out, cons
     int buf_size = RADE_RX_BUF_SIZE;
     memmove(rx->rx_buf, &rx->rx_buf[rx->nin], sizeof(RADE_COMP) * (buf_size - rx->nin));
     memcpy(&rx->rx_buf[buf_size - rx->nin], rx_samples, sizeof(RADE_COMP) * rx->nin);
+    rade_acq_shift(&rx->acq, rx->nin);
 
     /* State machine processing */
     int candidate = 0;
-    int valid = 0;
+    int *tmax_cand = fr->tmax_cand;
+    float *fmax_cand = fr->fmax_cand;
+    int *valid_cand = fr->valid_cand;
+    int searched = 0;
+    memset(valid_cand, 0, sizeof(fr->valid_cand));
 
     if (rx->state == RADE_STATE_SEARCH || rx->state == RADE_STATE_CANDIDATE) {
-        /* Acquisition mode: detect pilots */
-        candidate = rade_acq_detect_pilots(&rx->acq, rx->rx_buf, &rx->tmax, &rx->fmax);
+        /* Acquisition mode: detect pilots.  Candidates are first checked
+           near where they were found, only going back to the full search if
+           they have all gone.  The gate looks at the raw input, as the BPF
+           would remove its reference bands */
+        if (rx->state == RADE_STATE_CANDIDATE) {
+            candidate = rade_acq_verify_candidates(&rx->acq, rx->rx_buf, rx->n_candidate,
+                                                   rx->tmax_candidate, rx->fmax_candidate, Ncp - 1,
+                                                   tmax_cand, fmax_cand, valid_cand) > 0;
+            if (candidate) {
+                for (int i = rx->n_candidate - 1; i >= 0; i--) {
+                    if (valid_cand[i]) {
+                        rx->tmax = tmax_cand[i];
+                        rx->fmax = fmax_cand[i];
+                    }
+                }
+            } else {
+                candidate = rade_acq_detect_pilots(&rx->acq, rx->rx_buf, &rx->tmax, &rx->fmax);
+                searched = rx->acq.complete;
+
+                /* The full search may still find one of them */
+                for (int i = 0; i < rx->n_candidate && candidate; i++) {
+                    if (abs(rx->tmax - rx->tmax_candidate[i]) < Ncp) {
+                        valid_cand[i] = 1;
+                        tmax_cand[i] = rx->tmax;
+                        fmax_cand[i] = rx->fmax;
+                        break;
+                    }
+                }
+            }
+        } else if (rade_gate_process(&rx->gate, rx_in, rx->nin)) {
+            candidate = rade_acq_detect_pilots(&rx->acq, rx->rx_buf, &rx->tmax, &rx->fmax);
+        }
+    } else if (rx->state == RADE_STATE_LOST) {
+        /* Signal recently lost (e.g. a fade): look for it where it was
+           before falling back to the full search */
+        candidate = rade_acq_verify_pilots(&rx->acq, rx->rx_buf, rx->tmax_lock, Ncp - 1,
+                                           rx->fmax_lock, &rx->tmax, &rx->fmax);
     } else {
-        /* Sync mode: refine timing/freq and check pilots */
-        float ffine_start = rx->fmax - 1.0f;
-        float ffine_end = rx->fmax + 1.0f;
+        /* Sync mode: track timing/freq and check pilots */
         int tfine_start = (rx->tmax > 8) ? (rx->tmax - 8) : 0;
         int tfine_end = rx->tmax + 8;
 
         float fmax_hat = rx->fmax;
-        rade_acq_refine(&rx->acq, rx->rx_buf, &rx->tmax, &fmax_hat,
-                       tfine_start, tfine_end, ffine_start, ffine_end, 0.1f);
+        rade_acq_track(&rx->acq, rx->rx_buf, &rx->tmax, &fmax_hat,
+                       tfine_start, tfine_end, 1.0f);
 
         /* Low-pass filter frequency estimate */
         rx->fmax = 0.9f * rx->fmax + 0.1f * fmax_hat;
@@ -202,10 +339,12 @@ int rade_rx_process(rade_rx_state *rx, float *features_out, float *eoo_out, cons
         if (rx->tmax >= Nmf - M) {
             rx->nin = Nmf + M;
             rx->tmax -= M;
+            rx->tmax_lock -= M;
         }
         if (rx->tmax < M) {
             rx->nin = Nmf - M;
             rx->tmax += M;
+            rx->tmax_lock += M;
         }
 
         rx->synced_count++;
@@ -222,22 +361,13 @@ int rade_rx_process(rade_rx_state *rx, float *features_out, float *eoo_out, cons
         float w = 2.0f * M_PI * rx->fmax / Fs;
         RADE_COMP rx_corrected[RADE_NMF + RADE_M + RADE_NCP];
 
-        RADE_COMP rx_phase;
-        for (int n = 0; n < Nmf + M + Ncp; n++) {
-            rx_phase = rade_cmul(rx->rx_phase, rade_cexp(-w*(n+1)));
-            rx_corrected[n] = rade_cmul(rx->rx_buf[rx->tmax - Ncp + n], rx_phase);
-        }
-        rx->rx_phase = rx_phase;
-
-        /* Normalize phase to prevent drift */
-        //float phase_mag = rade_cabs(rx->rx_phase);
-        //rx->rx_phase = rade_cscale(rx->rx_phase, 1.0f / phase_mag);
+        rade_nco_set_freq(&rx->nco, -w);
+        rade_nco_mix(&rx->nco, rx_corrected, &rx->rx_buf[rx->tmax - Ncp], Nmf + M + Ncp);
 
         /* Demodulate OFDM frame */
-        float z_hat[RADE_NZMF * RADE_LATENT_DIM];
         float snr_est = 0.0f;
 
-        rade_ofdm_demod_frame(&rx->ofdm, z_hat, rx_corrected,
+        rade_ofdm_demod_frame(&rx->ofdm, fr->z_hat, rx_corrected,
                               rx->time_offset, endofover, rx->coarse_mag, &snr_est);
 
         /* Update SNR estimate with moving average */
@@ -245,50 +375,6 @@ int rade_rx_process(rade_rx_state *rx, float *features_out, float *eoo_out, cons
 
         valid_output = !endofover;
 
-        if (valid_output) {
-            /* Decode latents to features */
-            int Nzmf = RADE_NZMF;
-            int latent_dim = RADE_LATENT_DIM;
-            int dec_stride = RADE_FRAMES_PER_STEP;
-            int num_used_features = RADE_NUM_FEATURES;
-            int nb_total_features = RADE_NB_TOTAL_FEATURES;
-            int num_features = rx->num_features;
-            int arch = 0;
-
-            /* Zero output buffer */
-            int n_features_out = rade_rx_n_features_out(rx);
-            memset(features_out, 0, sizeof(float) * n_features_out);
-
-            int uw_errors_total = 0;
-
-            for (int c = 0; c < Nzmf; c++) {
-                float dec_features[RADE_FRAMES_PER_STEP * RADE_NUM_FEATURES_AUX];
-
-                rade_core_decoder(&rx->dec_state, &rx->dec_model,
-                                 dec_features, &z_hat[c * latent_dim], arch);
-
-                /* Copy decoded features to output (with padding) */
-                for (int i = 0; i < dec_stride; i++) {
-                    int out_idx = (c * dec_stride + i) * nb_total_features;
-                    for (int j = 0; j < num_used_features; j++) {
-                        features_out[out_idx + j] = dec_features[i * num_features + j];
-                    }
-                }
-
-                /* Check auxiliary data for unique word errors */
-                if (rx->auxdata) {
-                    /* Use first aux symbol of each group (they repeat) */
-                    if (dec_features[num_used_features] > 0) {
-                        uw_errors_total++;
-                    }
-                }
-            }
-
-            if (rx->auxdata) {
-                rx->uw_errors += uw_errors_total;
-            }
-        }
-
         if (endofover) {
             /* Copy EOO symbols to output */
             float z_hat_eoo[(RADE_NS - 1) * RADE_NC * 2];
@@ -299,13 +385,57 @@ int rade_rx_process(rade_rx_state *rx, float *features_out, float *eoo_out, cons
         }
     }
 
+    fr->candidate = candidate;
+    fr->searched = searched;
+    fr->endofover = endofover;
+    fr->uw_fail = uw_fail;
+    fr->valid_output = valid_output;
+}
+
+/* Features for latent vector c of the frame from the decoder output, and
+   its unique word errors */
+static void rx_features(rade_rx_state *rx, float *features_out, const float *dec_features, int c) {
+    int dec_stride = RADE_FRAMES_PER_STEP;
+    int num_used_features = RADE_NUM_FEATURES;
+    int nb_total_features = RADE_NB_TOTAL_FEATURES;
+    int num_features = rx->num_features;
+
+    /* Copy decoded features to output (with padding) */
+    for (int i = 0; i < dec_stride; i++) {
+        int out_idx = (c * dec_stride + i) * nb_total_features;
+        for (int j = 0; j < num_used_features; j++) {
+            features_out[out_idx + j] = dec_features[i * num_features + j];
+        }
+    }
+
+    /* Check auxiliary data for unique word errors, using the first aux
+       symbol of each group (they repeat) */
+    if (rx->auxdata && dec_features[num_used_features] > 0) {
+        rx->uw_errors++;
+    }
+}
+
+static int rx_back(rade_rx_state *rx, rx_frame *fr) {
+    int Nmf = RADE_NMF;
+    float Fs = (float)RADE_FS;
+
+    int prev_state = fr->prev_state;
+    int candidate = fr->candidate;
+    int endofover = fr->endofover;
+    int *tmax_cand = fr->tmax_cand;
+    const float *fmax_cand = fr->fmax_cand;
+    const int *valid_cand = fr->valid_cand;
+
     /* Verbose output */
     if (rx->verbose == 2 ||
         (rx->verbose == 1 && (rx->state == RADE_STATE_SEARCH ||
                               rx->state == RADE_STATE_CANDIDATE ||
-                              prev_state == RADE_STATE_CANDIDATE))) {
+                              rx->state == RADE_STATE_LOST ||
+                              prev_state == RADE_STATE_CANDIDATE ||
+                              prev_state == RADE_STATE_LOST))) {
         const char *state_str = (rx->state == RADE_STATE_SEARCH) ? "search" :
-                                (rx->state == RADE_STATE_CANDIDATE) ? "candidate" : "sync";
+                                (rx->state == RADE_STATE_CANDIDATE) ? "candidate" :
+                                (rx->state == RADE_STATE_LOST) ? "lost" : "sync";
         fprintf(stderr, "%3d state: %10s valid: %d %d %2d Dthresh: %8.2f ",
                 rx->mf, state_str, candidate, endofover, rx->valid_count, rx->acq.Dthresh);
         fprintf(stderr, "Dtmax12: %8.2f %8.2f tmax: %4d fmax: %6.2f",
@@ -323,28 +453,49 @@ int rade_rx_process(rade_rx_state *rx, float *features_out, float *eoo_out, cons
     if (rx->state == RADE_STATE_SEARCH) {
         if (candidate) {
             next_state = RADE_STATE_CANDIDATE;
-            rx->tmax_candidate = rx->tmax;
-            rx->valid_count = 1;
+            rx_start_candidates(rx);
         }
     } else if (rx->state == RADE_STATE_CANDIDATE) {
-        /* Look for 3 consecutive matches with similar timing */
-        if (candidate && abs(rx->tmax - rx->tmax_candidate) < Ncp) {
-            rx->valid_count++;
-            if (rx->valid_count > 3) {
-                next_state = RADE_STATE_SYNC;
-                rade_init_decoder(&rx->dec_state);  /* Reset decoder state */
-                rx->synced_count = 0;
-                rx->uw_errors = 0;
-                rx->valid_count = rx->Nmf_unsync;
-
-                /* Fine refinement of timing/frequency */
-                float ffine_start = rx->fmax - 10.0f;
-                float ffine_end = rx->fmax + 10.0f;
-                int tfine_start = (rx->tmax > 1) ? (rx->tmax - 1) : 0;
-                int tfine_end = rx->tmax + 2;
-
-                rade_acq_refine(&rx->acq, rx->rx_buf, &rx->tmax, &rx->fmax,
-                               tfine_start, tfine_end, ffine_start, ffine_end, 0.25f);
+        /* Keep the candidates seen again with similar timing, and sync on
+           the first with 3 more consecutive matches */
+        int n = 0;
+        int sync_cand = -1;
+        for (int i = 0; i < rx->n_candidate; i++) {
+            if (valid_cand[i]) {
+                rx->tmax_candidate[n] = rx->tmax_candidate[i];
+                rx->fmax_candidate[n] = fmax_cand[i];
+                rx->valid_candidate[n] = rx->valid_candidate[i] + 1;
+                tmax_cand[n] = tmax_cand[i];
+                if (rx->valid_candidate[n] > 3 && sync_cand < 0) {
+                    sync_cand = n;
+                }
+                n++;
+            }
+        }
+
+        /* The rest of a fallback search is new candidates.  Its best peak
+           has been used above if it matched one */
+        if (fr->searched) {
+            for (int j = (n > 0) ? 1 : 0; j < rx->acq.n_cand && n < RADE_ACQ_TOPK; j++) {
+                rx->tmax_candidate[n] = rx->acq.cand[j].t;
+                rx->fmax_candidate[n] = rx->acq.cand[j].f;
+                rx->valid_candidate[n] = 1;
+                n++;
+            }
+        }
+        rx->n_candidate = n;
+
+        if (sync_cand >= 0) {
+            next_state = RADE_STATE_SYNC;
+            rx->tmax = tmax_cand[sync_cand];
+            rx->fmax = rx->fmax_candidate[sync_cand];
+            rx_enter_sync(rx);
+        } else if (n > 0) {
+            rx->valid_count = 0;
+            for (int i = 0; i < n; i++) {
+                if (rx->valid_candidate[i] > rx->valid_count) {
+                    rx->valid_count = rx->valid_candidate[i];
+                }
             }
         } else {
             next_state = RADE_STATE_SEARCH;
@@ -361,24 +512,130 @@ int rade_rx_process(rade_rx_state *rx, float *features_out, float *eoo_out, cons
 
         if (candidate) {
             rx->valid_count = rx->Nmf_unsync;
+            rx->tmax_lock = rx->tmax;
+            rx->fmax_lock = rx->fmax;
         } else {
             rx->valid_count--;
             if (unsync_enable && rx->valid_count == 0) {
-                next_state = RADE_STATE_SEARCH;
+                /* Pilots faded out rather than the over ending, so the
+                   signal is likely to come back where it was */
+                next_state = RADE_STATE_LOST;
+                rx->lost_count = rx->Nmf_lost;
+
+                /* nin goes back to Nmf, undo any slip applied this frame */
+                rx->tmax_lock += rx->nin - Nmf;
             }
         }
 
-        if (unsync_enable && (endofover || uw_fail)) {
+        if (unsync_enable && (endofover || fr->uw_fail)) {
+            next_state = RADE_STATE_SEARCH;
+        }
+    } else if (rx->state == RADE_STATE_LOST) {
+        /* Confidence in the old timing decays: soon after losing the
+           signal one hit is enough, later it takes two in a row */
+        if (candidate) {
+            rx->valid_count++;
+            int valid_needed = (rx->lost_count > rx->Nmf_lost / 2) ? 1 : 2;
+            if (rx->valid_count >= valid_needed) {
+                next_state = RADE_STATE_SYNC;
+                rx_enter_sync(rx);
+            }
+        } else {
+            rx->valid_count = 0;
+        }
+
+        rx->lost_count--;
+        if (next_state == RADE_STATE_LOST && rx->lost_count <= 0) {
             next_state = RADE_STATE_SEARCH;
         }
     }
 
+    if ((next_state == RADE_STATE_SEARCH || next_state == RADE_STATE_LOST) &&
+        rx->state != next_state) {
+        /* Search straight away after losing a signal, and don't finish a
+           budgeted search with grid columns from before it */
+        rade_gate_reset(&rx->gate);
+        rade_acq_reset(&rx->acq);
+    }
     rx->state = next_state;
-    if (rx->state == RADE_STATE_SEARCH) {
+    if (rx->state == RADE_STATE_SEARCH || rx->state == RADE_STATE_LOST) {
         rx->nin = Nmf;  /* Reset nin when not synced */
     }
     rx->mf++;
 
     /* Return flags */
-    return (valid_output ? 0x1 : 0) | (endofover ? 0x2 : 0);
+    return (fr->valid_output ? 0x1 : 0) | (endofover ? 0x2 : 0);
+}
+
+int rade_rx_process(rade_rx_state *rx, float *features_out, float *eoo_out, const RADE_COMP *rx_in) {
+    rx_frame fr;
+    rx_front(rx, &fr, eoo_out, rx_in);
+
+    if (fr.valid_output) {
+        /* Decode latents to features */
+        memset(features_out, 0, sizeof(float) * rade_rx_n_features_out(rx));
+        for (int c = 0; c < RADE_NZMF; c++) {
+            float dec_features[RADE_FRAMES_PER_STEP * RADE_NUM_FEATURES_AUX];
+            rade_core_decoder(&rx->dec_state, rx->dec_model,
+                              dec_features, &fr.z_hat[c * RADE_LATENT_DIM], rx->nn_arch);
+            rx_features(rx, features_out, dec_features, c);
+        }
+    }
+
+    return rx_back(rx, &fr);
+}
+
+void rade_rx_process_batch(rade_rx_state **rx, int n, float **features_out, float **eoo_out,
+                           const RADE_COMP **rx_in, int *ret) {
+    for (int i0 = 0; i0 < n; i0 += RADE_NN_BATCH) {
+        int nb = (n - i0 < RADE_NN_BATCH) ? n - i0 : RADE_NN_BATCH;
+        rx_frame fr[RADE_NN_BATCH];
+
+        /* Front ends, then the receivers with latents to decode.  Those
+           with the weights and NN kernels of the first go in one batch */
+        int ndec = 0, idx[RADE_NN_BATCH];
+        rade_rx_state *lead = NULL;
+        for (int i = 0; i < nb; i++) {
+            rx_front(rx[i0 + i], &fr[i], eoo_out[i0 + i], rx_in[i0 + i]);
+            if (!fr[i].valid_output) {
+                continue;
+            }
+            memset(features_out[i0 + i], 0, sizeof(float) * rade_rx_n_features_out(rx[i0 + i]));
+            if (lead == NULL) {
+                lead = rx[i0 + i];
+            }
+            if (rx[i0 + i]->nn_arch == lead->nn_arch &&
+                (rx[i0 + i]->dec_model == lead->dec_model ||
+                 memcmp(rx[i0 + i]->dec_model, lead->dec_model, sizeof(RADEDec)) == 0)) {
+                idx[ndec++] = i;
+            } else {
+                for (int c = 0; c < RADE_NZMF; c++) {
+                    float dec_features[RADE_FRAMES_PER_STEP * RADE_NUM_FEATURES_AUX];
+                    rade_core_decoder(&rx[i0 + i]->dec_state, rx[i0 + i]->dec_model, dec_features,
+                                      &fr[i].z_hat[c * RADE_LATENT_DIM], rx[i0 + i]->nn_arch);
+                    rx_features(rx[i0 + i], features_out[i0 + i], dec_features, c);
+                }
+            }
+        }
+
+        for (int c = 0; c < RADE_NZMF && ndec > 0; c++) {
+            float dec_features[RADE_NN_BATCH][RADE_FRAMES_PER_STEP * RADE_NUM_FEATURES_AUX];
+            RADEDecState *dec_states[RADE_NN_BATCH];
+            float *dec_out[RADE_NN_BATCH];
+            const float *z_hat[RADE_NN_BATCH];
+            for (int k = 0; k < ndec; k++) {
+                dec_states[k] = &rx[i0 + idx[k]]->dec_state;
+                dec_out[k] = dec_features[k];
+                z_hat[k] = &fr[idx[k]].z_hat[c * RADE_LATENT_DIM];
+            }
+            rade_core_decoder_batch(dec_states, lead->dec_model, dec_out, z_hat, ndec, lead->nn_arch);
+            for (int k = 0; k < ndec; k++) {
+                rx_features(rx[i0 + idx[k]], features_out[i0 + idx[k]], dec_features[k], c);
+            }
+        }
+
+        for (int i = 0; i < nb; i++) {
+            ret[i0 + i] = rx_back(rx[i0 + i], &fr[i]);
+        }
+    }
 }
@@ -41,7 +41,9 @@
 #include "rade_ofdm.h"
 #include "rade_bpf.h"
 #include "rade_acq.h"
+#include "rade_gate.h"
 #include "rade_dec.h"
+#include "rade_model.h"
 #include "../src/radae_top/rade_core.h"
 
 #ifdef __cplusplus
@@ -60,11 +62,16 @@ typedef struct {
     rade_ofdm ofdm;
     rade_bpf bpf;
     rade_acq acq;
+    rade_gate gate;           /* Thins out search on dead air */
+    int gate_period;          /* Gate period asked for, see rade_rx_set_search_gate() */
+    float frange;             /* Frequency search range (Hz) */
     int bpf_en;
 
-    /* Core decoder */
-    RADEDec dec_model;
+    /* Core decoder, weights shared read only */
+    const rade_model *model;
+    const RADEDec *dec_model; /* model->dec[0], or dec[1] on int8 */
     RADEDecState dec_state;
+    int nn_arch;              /* Opus NN kernels (opus_select_arch()), 0 = generic C */
 
     /* Configuration */
     int bottleneck;
@@ -74,20 +81,29 @@ typedef struct {
     int time_offset;          /* Fine timing adjustment (default -16) */
 
     /* State machine */
-    int state;                /* RADE_STATE_SEARCH, CANDIDATE, or SYNC */
+    int state;                /* RADE_STATE_SEARCH, CANDIDATE, SYNC or LOST */
     int valid_count;
     int synced_count;
     int uw_errors;
     int Nmf_unsync;           /* Modem frames before losing sync */
+    int Nmf_lost;             /* Modem frames spent probing a lost signal */
+    int lost_count;           /* Probes left before a full search */
     int synced_count_one_sec; /* Modem frames in one second */
 
     /* Timing and frequency tracking */
     int tmax;
-    int tmax_candidate;
     float fmax;
-    RADE_COMP rx_phase;
+    int tmax_lock;            /* Timing and frequency at the last valid */
+    float fmax_lock;          /* pilots in sync, where LOST probes */
+    rade_nco nco;             /* Frequency offset correction */
     int nin;                  /* Samples needed for next call */
 
+    /* Search peaks followed in RADE_STATE_CANDIDATE, strongest first */
+    int n_candidate;
+    int tmax_candidate[RADE_ACQ_TOPK];
+    float fmax_candidate[RADE_ACQ_TOPK];
+    int valid_candidate[RADE_ACQ_TOPK];   /* Frames each has been seen */
+
     /* Receive buffer */
     RADE_COMP rx_buf[RADE_RX_BUF_SIZE];
 
@@ -110,16 +126,39 @@ typedef struct {
 \*---------------------------------------------------------------------------*/
 
 /* Initialize receiver
-   dec_model: pointer to decoder model weights (can be NULL to use built-in)
+   model: decoder weights (rade_model_init()), kept until the receiver is done
    bottleneck: 1, 2, or 3
    auxdata: 1 to enable auxiliary data decoding
    bpf_en: 1 to enable input bandpass filter
-   Returns 0 on success */
-int rade_rx_init(rade_rx_state *rx, const RADEDec *dec_model, int bottleneck, int auxdata, int bpf_en);
+   nn_arch starts at 0, generic C, for the caller to raise
+   Returns 0 on success.  rade_rx_close() rx when done, whether or not it
+   succeeded, and before initialising it again */
+int rade_rx_init(rade_rx_state *rx, const rade_model *model, int bottleneck, int auxdata, int bpf_en);
+
+/* Free what rade_rx_init() set up, stopping any acquisition worker
+   threads */
+void rade_rx_close(rade_rx_state *rx);
+
+/* Decode on the int8 weights of the layers exported with them (enable = 1)
+   or on the weights as loaded (0), float unless they have no float
+   copies.  Returns 0 on success, -1 if the model hasn't got the weights
+   asked for */
+int rade_rx_set_nn_int8(rade_rx_state *rx, int enable);
 
 /* Reset receiver state (go back to search mode) */
 void rade_rx_reset(rade_rx_state *rx);
 
+/* Search for signals anywhere within frange (Hz) of the expected frequency,
+   widening the input BPF to match.  Resets the receiver.  Returns 0 on
+   success, -1 if the range is not supported (see rade_acq_init()) */
+int rade_rx_set_frange(rade_rx_state *rx, float frange);
+
+/* Run the full search only every period frames while the gate sees no
+   signal, period <= 1 searching every frame.  The gate's reference bands
+   sit just outside the default search range, so it stays off while a
+   wider range is searched */
+void rade_rx_set_search_gate(rade_rx_state *rx, int period);
+
 /*---------------------------------------------------------------------------*\
                            RECEPTION
 \*---------------------------------------------------------------------------*/
@@ -155,6 +194,13 @@ float rade_rx_freq_offset(const rade_rx_state *rx);
    - bit 1 (0x2): end-of-over detected, eoo_out contains soft decision bits */
 int rade_rx_process(rade_rx_state *rx, float *features_out, float *eoo_out, const RADE_COMP *rx_in);
 
+/* Process one modem frame for each of n receivers, as n calls to
+   rade_rx_process() would, with ret[i] its return value.  Receivers with
+   the same decoder weights and nn_arch decode together, RADE_NN_BATCH at a
+   time, reading each weight once for the batch */
+void rade_rx_process_batch(rade_rx_state **rx, int n, float **features_out, float **eoo_out,
+                           const RADE_COMP **rx_in, int *ret);
+
 /* Report unique word errors (called externally if C decoder is used)
    This is used by the state machine for unsync detection */
 void rade_rx_sum_uw_errors(rade_rx_state *rx, int new_uw_errors);
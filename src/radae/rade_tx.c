@@ -42,7 +42,7 @@
                            INITIALIZATION
 \*---------------------------------------------------------------------------*/
 
-int rade_tx_init(rade_tx_state *tx, const RADEEnc *enc_model, int bottleneck, int auxdata, int bpf_en) {
+int rade_tx_init(rade_tx_state *tx, const rade_model *model, int bottleneck, int auxdata, int bpf_en) {
     memset(tx, 0, sizeof(rade_tx_state));
 
     tx->bottleneck = bottleneck;
@@ -53,16 +53,12 @@ int rade_tx_init(rade_tx_state *tx, const RADEEnc *enc_model, int bottleneck, in
     /* Initialize OFDM modulator */
     rade_ofdm_init(&tx->ofdm, bottleneck);
 
-    /* Initialize encoder if model provided */
-    if (enc_model != NULL) {
-        memcpy(&tx->enc_model, enc_model, sizeof(RADEEnc));
-    } else {
-        /* Use built-in weights */
-        int input_dim = tx->num_features * RADE_FRAMES_PER_STEP;
-        if (init_radeenc(&tx->enc_model, radeenc_arrays, input_dim) != 0) {
-            return -1;
-        }
+    /* Initialize encoder, on the weights as loaded */
+    if (model == NULL) {
+        return -1;
     }
+    tx->model = model;
+    tx->enc_model = &model->enc[0];
     rade_init_encoder(&tx->enc_state);
 
     /* Initialize Tx BPF if enabled */
@@ -84,6 +80,20 @@ int rade_tx_init(rade_tx_state *tx, const RADEEnc *enc_model, int bottleneck, in
     return 0;
 }
 
+int rade_tx_set_nn_int8(rade_tx_state *tx, int enable) {
+    const RADEEnc *enc_model = &tx->model->enc[enable ? 1 : 0];
+    if ((rade_enc_int8_layers(enc_model) > 0) != (enable != 0)) {
+        return -1;
+    }
+    tx->enc_model = enc_model;
+    return 0;
+}
+
+void rade_tx_close(rade_tx_state *tx) {
+    rade_ofdm_close(&tx->ofdm);
+    rade_bpf_close(&tx->bpf);
+}
+
 void rade_tx_reset(rade_tx_state *tx) {
     rade_init_encoder(&tx->enc_state);
     if (tx->bpf_en) {
@@ -123,7 +133,6 @@ int rade_tx_process(rade_tx_state *tx, RADE_COMP *tx_out, const float *features_
     int num_features = tx->num_features;
     int num_used_features = RADE_NUM_FEATURES;
     int nb_total_features = RADE_NB_TOTAL_FEATURES;
-    int arch = 0;  /* CPU architecture for optimized routines */
 
     /* Number of encoder calls per modem frame */
     int n_feature_vecs = Nzmf * enc_stride;
@@ -154,8 +163,8 @@ int rade_tx_process(rade_tx_state *tx, RADE_COMP *tx_out, const float *features_
         }
 
         /* Run core encoder */
-        rade_core_encoder(&tx->enc_state, &tx->enc_model,
-                         &z[c * latent_dim], enc_features, arch, tx->bottleneck);
+        rade_core_encoder(&tx->enc_state, tx->enc_model,
+                         &z[c * latent_dim], enc_features, tx->nn_arch, tx->bottleneck);
     }
 
     /* Modulate latent vectors to IQ samples */
@@ -40,6 +40,7 @@
 #include "rade_ofdm.h"
 #include "rade_bpf.h"
 #include "rade_enc.h"
+#include "rade_model.h"
 #include "../src/radae_top/rade_core.h"
 
 #ifdef __cplusplus
@@ -58,9 +59,11 @@ typedef struct {
     rade_bpf bpf;
     int bpf_en;
 
-    /* Core encoder */
-    RADEEnc enc_model;
+    /* Core encoder, weights shared read only */
+    const rade_model *model;
+    const RADEEnc *enc_model; /* model->enc[0], or enc[1] on int8 */
     RADEEncState enc_state;
+    int nn_arch;            /* Opus NN kernels (opus_select_arch()), 0 = generic C */
 
     /* Configuration */
     int bottleneck;
@@ -78,12 +81,23 @@ typedef struct {
 \*---------------------------------------------------------------------------*/
 
 /* Initialize transmitter
-   enc_model: pointer to encoder model weights (can be NULL to skip encoder init)
+   model: encoder weights (rade_model_init()), kept until the transmitter is done
    bottleneck: 1, 2, or 3 (PA saturation model)
    auxdata: 1 to enable auxiliary data symbols
    bpf_en: 1 to enable Tx bandpass filter
-   Returns 0 on success */
-int rade_tx_init(rade_tx_state *tx, const RADEEnc *enc_model, int bottleneck, int auxdata, int bpf_en);
+   nn_arch starts at 0, generic C, for the caller to raise
+   Returns 0 on success.  rade_tx_close() tx when done, whether or not it
+   succeeded, and before initialising it again */
+int rade_tx_init(rade_tx_state *tx, const rade_model *model, int bottleneck, int auxdata, int bpf_en);
+
+/* Free what rade_tx_init() set up */
+void rade_tx_close(rade_tx_state *tx);
+
+/* Encode on the int8 weights of the layers exported with them (enable = 1)
+   or on the weights as loaded (0), float unless they have no float
+   copies.  Returns 0 on success, -1 if the model hasn't got the weights
+   asked for */
+int rade_tx_set_nn_int8(rade_tx_state *tx, int enable);
 
 /* Reset transmitter state (clear encoder state) */
 void rade_tx_reset(rade_tx_state *tx);
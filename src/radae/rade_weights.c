@@ -0,0 +1,183 @@
+/*---------------------------------------------------------------------------*\
+
+  rade_weights.c
+
+  External NN weight files for RADAE C implementation.
+
+\*---------------------------------------------------------------------------*/
+
+/*
+  Copyright (C) 2024 David Rowe
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  - Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE FOUNDATION OR
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define RADE_WEIGHTS_MMAP
+#endif
+
+#include "rade_weights.h"
+
+/*---------------------------------------------------------------------------*\
+                           WEIGHT FILES
+\*---------------------------------------------------------------------------*/
+
+static int read_blob(rade_weights *w, const char *filename) {
+#ifdef RADE_WEIGHTS_MMAP
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < WEIGHT_BLOCK_SIZE) {
+        close(fd);
+        return -1;
+    }
+    void *blob = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (blob == MAP_FAILED) {
+        return -1;
+    }
+    w->blob = blob;
+    w->len = st.st_size;
+    w->mapped = 1;
+#else
+    FILE *f = fopen(filename, "rb");
+    if (f == NULL) {
+        return -1;
+    }
+    fseek(f, 0L, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0L, SEEK_SET);
+    void *blob = (len >= WEIGHT_BLOCK_SIZE) ? malloc(len) : NULL;
+    if (blob == NULL || fread(blob, 1, len, f) != (size_t)len) {
+        free(blob);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    w->blob = blob;
+    w->len = len;
+    w->mapped = 0;
+#endif
+    return 0;
+}
+
+int rade_weights_open(rade_weights *w, const char *filename) {
+    memset(w, 0, sizeof(rade_weights));
+    if (read_blob(w, filename) != 0) {
+        return -1;
+    }
+
+    /* Check the magic first, so other files (e.g. the old .pth model names)
+       are turned away without parsing them */
+    if (memcmp(w->blob, "DNNw", 4) != 0 || w->len > 0x7fffffff ||
+        parse_weights(&w->arrays, w->blob, (int)w->len) <= 0) {
+        rade_weights_close(w);
+        return -1;
+    }
+    return 0;
+}
+
+void rade_weights_close(rade_weights *w) {
+    free(w->arrays);
+    if (w->blob != NULL) {
+#ifdef RADE_WEIGHTS_MMAP
+        if (w->mapped) {
+            munmap(w->blob, w->len);
+        } else
+#endif
+        {
+            free(w->blob);
+        }
+    }
+    memset(w, 0, sizeof(rade_weights));
+}
+
+/* Float copy of a layer that also has int8 weights */
+static int is_float_copy(const WeightArray *list, const char *name) {
+    const char *suffix = "_weights_float";
+    size_t n = strlen(name), ns = strlen(suffix);
+    if (n < ns || strcmp(name + n - ns, suffix) != 0) {
+        return 0;
+    }
+    char int8_name[128];
+    snprintf(int8_name, sizeof(int8_name), "%.*s_weights_int8", (int)(n - ns), name);
+    for (int i = 0; list[i].name != NULL; i++) {
+        if (strcmp(list[i].name, int8_name) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+long rade_weights_write(const char *filename, const WeightArray *const *lists, int nlists, int int8_only) {
+    FILE *f = fopen(filename, "wb");
+    if (f == NULL) {
+        return -1;
+    }
+
+    static const unsigned char zeros[WEIGHT_BLOCK_SIZE];
+    long len = 0;
+    int ok = 1;
+    for (int l = 0; l < nlists; l++) {
+        for (const WeightArray *a = lists[l]; a->name != NULL && ok; a++) {
+            if (int8_only && is_float_copy(lists[l], a->name)) {
+                continue;
+            }
+
+            WeightHead h;
+            memset(&h, 0, sizeof(h));
+            if (strlen(a->name) >= sizeof(h.name)) {
+                ok = 0;
+                break;
+            }
+            memcpy(h.head, "DNNw", 4);
+            h.version = WEIGHT_BLOB_VERSION;
+            h.type = a->type;
+            h.size = a->size;
+            h.block_size = (a->size + WEIGHT_BLOCK_SIZE - 1) / WEIGHT_BLOCK_SIZE * WEIGHT_BLOCK_SIZE;
+            strcpy(h.name, a->name);
+
+            ok = fwrite(&h, 1, sizeof(h), f) == sizeof(h) &&
+                 fwrite(a->data, 1, a->size, f) == (size_t)a->size &&
+                 fwrite(zeros, 1, h.block_size - a->size, f) == (size_t)(h.block_size - a->size);
+            len += sizeof(h) + h.block_size;
+        }
+    }
+
+    if (fclose(f) != 0 || !ok) {
+        remove(filename);
+        return -1;
+    }
+    return len;
+}
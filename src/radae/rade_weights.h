@@ -0,0 +1,81 @@
+/*---------------------------------------------------------------------------*\
+
+  rade_weights.h
+
+  External NN weight files for RADAE C implementation.
+
+\*---------------------------------------------------------------------------*/
+
+/*
+  Copyright (C) 2024 David Rowe
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  - Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE FOUNDATION OR
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifndef __RADE_WEIGHTS__
+#define __RADE_WEIGHTS__
+
+#include <stddef.h>
+#include "nnet.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*---------------------------------------------------------------------------*\
+                           WEIGHT FILES
+\*---------------------------------------------------------------------------*/
+
+/* A weight file is the Opus weight blob (parse_weights()): for each array
+   a 64 byte WeightHead ("DNNw", version, type, size, padded size, name)
+   then its data zero padded to a multiple of 64 bytes.  Arrays are used
+   where they lie in the file, 64 byte aligned, so a file mapped read only
+   is shared by every process using it */
+
+typedef struct {
+    void *blob;             /* File contents, NULL if none open */
+    size_t len;
+    int mapped;             /* blob is mmap()ed rather than read in */
+    WeightArray *arrays;    /* Index of the file, NULL name terminated */
+} rade_weights;
+
+/* Map filename and index its arrays, pointing into the mapping.  Returns 0
+   on success, -1 if the file can't be read or isn't a weight file */
+int rade_weights_open(rade_weights *w, const char *filename);
+
+/* Unmap the file, after any model pointing into it has gone */
+void rade_weights_close(rade_weights *w);
+
+/* Write the nlists NULL name terminated lists of arrays (such as
+   radeenc_arrays and radedec_arrays) to filename.  With int8_only, float
+   weights of layers that also have int8 weights are left out.  Returns
+   the file size, or -1 on error */
+long rade_weights_write(const char *filename, const WeightArray *const *lists, int nlists, int int8_only);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RADE_WEIGHTS__ */
@@ -45,6 +45,24 @@ void rade_core_encoder(RADEEncState *enc_state, const RADEEnc *model, float *z,
 void rade_init_decoder(RADEDecState *dec_state);
 void rade_core_decoder(RADEDecState *dec_state, const RADEDec *model, float *features, const float *z_hat, int arch);
 
+/* rade_core_decoder() for nb independent streams sharing model, each layer
+   run as one matrix product over the streams so the weights are read once
+   per batch of RADE_NN_BATCH.  Its scratch is allocated per call, and
+   without it the streams are decoded one at a time */
+void rade_core_decoder_batch(RADEDecState **dec_states, const RADEDec *model, float **features,
+                             const float **z_hat, int nb, int arch);
+
+/* The GRU, GLU and conv layers are exported with int8 weights (per row
+   scales) as well as float copies, and Opus runs the float copies when
+   present.  rade_*_use_int8() drops them from a model so those layers run
+   on int8 (cgemv8x4(), inputs quantized to 8 bits), rade_*_int8_layers()
+   counts the layers that do.  Built with DISABLE_DEBUG_FLOAT the float
+   copies aren't compiled in at all */
+void rade_enc_use_int8(RADEEnc *model);
+int rade_enc_int8_layers(const RADEEnc *model);
+void rade_dec_use_int8(RADEDec *model);
+int rade_dec_int8_layers(const RADEDec *model);
+
 extern const WeightArray radeenc_arrays[];
 extern const WeightArray radedec_arrays[];
 
@@ -186,6 +186,7 @@ void RadaeEncoder::close()
 
     if (rade_)   { rade_close(rade_);              rade_   = nullptr; }
     if (lpcnet_) { lpcnet_encoder_destroy(lpcnet_); lpcnet_ = nullptr; }
+    rade_bpf_close(&bpf_);
 
     stream_in_.close();
     stream_out_.close();
@@ -96,7 +96,7 @@ private:
     std::atomic<bool>  bpf_enabled_  {false};
 
     /* ── TX output bandpass filter ───────────────────────────────────────── */
-    rade_bpf           bpf_;
+    rade_bpf           bpf_          {};
 
     /* ── FFT / spectrum of TX output ─────────────────────────────────────── */
     float              fft_window_[FFT_SIZE]       = {};
@@ -45,7 +45,7 @@
 void usage(void) {
     fprintf(stderr, "usage: radae_rx [options]\n");
     fprintf(stderr, "  -h, --help              Show this help\n");
-    fprintf(stderr, "  --model_name FILE       Path to model (ignored, uses built-in weights)\n");
+    fprintf(stderr, "  --model_name FILE       Weight file (write_rade_weights), else built-in weights\n");
     fprintf(stderr, "  -v LEVEL                Verbosity level (0, 1, or 2)\n");
     fprintf(stderr, "  --disable_unsync SECS   Test mode: disable unsync after SECS seconds (default 0 = disabled)\n");
     fprintf(stderr, "\n");
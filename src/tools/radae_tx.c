@@ -46,7 +46,7 @@
 void usage(void) {
     fprintf(stderr, "usage: radae_tx [options]\n");
     fprintf(stderr, "  -h, --help           Show this help\n");
-    fprintf(stderr, "  --model_name FILE    Path to model (ignored, uses built-in weights)\n");
+    fprintf(stderr, "  --model_name FILE    Weight file (write_rade_weights), else built-in weights\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "Reads vocoder features from stdin, writes IQ samples to stdout.\n");
     fprintf(stderr, "Features format: float32, %d values per modem frame\n",
@@ -0,0 +1,66 @@
+/*---------------------------------------------------------------------------*\
+
+  write_rade_weights.c
+
+  Writes the RADE encoder and decoder weights built into the library to a
+  weight file, for rade_open() to map at run time.
+
+  usage: write_rade_weights [--int8] weights.bin
+
+\*---------------------------------------------------------------------------*/
+
+/*
+  Copyright (C) 2024 David Rowe
+
+  Redistribution and use in source and binary forms, with or without
+  modification, are permitted provided that the following conditions
+  are met:
+
+  - Redistributions of source code must retain the above copyright
+  notice, this list of conditions and the following disclaimer.
+
+  - Redistributions in binary form must reproduce the above copyright
+  notice, this list of conditions and the following disclaimer in the
+  documentation and/or other materials provided with the distribution.
+
+  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+  ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+  A PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE FOUNDATION OR
+  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdio.h>
+#include <string.h>
+
+#include "../src/radae/rade_weights.h"
+#include "../src/radae_top/rade_core.h"
+
+int main(int argc, char *argv[]) {
+    int int8_only = 0;
+    int arg = 1;
+    if (arg < argc && strcmp(argv[arg], "--int8") == 0) {
+        int8_only = 1;
+        arg++;
+    }
+    if (arg != argc - 1) {
+        fprintf(stderr, "usage: %s [--int8] weights.bin\n", argv[0]);
+        fprintf(stderr, "  --int8  leave out float weights of layers that have int8 weights\n");
+        return 1;
+    }
+
+    const WeightArray *lists[] = { radeenc_arrays, radedec_arrays };
+    long len = rade_weights_write(argv[arg], lists, 2, int8_only);
+    if (len < 0) {
+        fprintf(stderr, "%s: error writing %s\n", argv[0], argv[arg]);
+        return 1;
+    }
+    fprintf(stderr, "%s: %ld bytes\n", argv[arg], len);
+    return 0;
+}
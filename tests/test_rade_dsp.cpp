@@ -0,0 +1,1092 @@
+/**
+ * test_rade_dsp.cpp
+ *
+ * Checks the fast RADE DSP paths against their straightforward reference
+ * implementations.
+ *
+ * Run directly:  ./test_rade_dsp
+ * Run via CTest: ctest --test-dir build -R rade_dsp
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#include "radae/rade_acq.h"
+#include "radae/rade_api.h"
+#include "radae/rade_bpf.h"
+#include "radae/rade_fft.h"
+#include "radae/rade_gate.h"
+#include "radae/rade_ofdm.h"
+#include "radae/rade_rx.h"
+#include "radae/rade_weights.h"
+#include "radae_top/rade_core.h"
+
+#include "test_rade_tx.h"
+
+static int tests_run    = 0;
+static int tests_passed = 0;
+
+#define CHECK(expr, label)                                              \
+    do {                                                                \
+        ++tests_run;                                                    \
+        if (expr) {                                                     \
+            ++tests_passed;                                             \
+            std::printf("  PASS  %s\n", label);                        \
+        } else {                                                        \
+            std::printf("  FAIL  %s\n", label);                        \
+        }                                                               \
+    } while (0)
+
+// Small deterministic generator so runs are repeatable on every platform
+static unsigned int lcg_state = 1;
+
+static float uniform()
+{
+    lcg_state = lcg_state * 1103515245u + 12345u;
+    return ((lcg_state >> 8) & 0xffff) / 65536.0f - 0.5f;
+}
+
+static RADE_COMP noise(float amp)
+{
+    return rade_cmplx(amp * uniform(), amp * uniform());
+}
+
+// Modem for the tests that only read it (pilots, carriers), set up in main()
+static rade_ofdm ofdm;
+
+// Acquisition state searching frange Hz either side at the default step
+static void acq_init(rade_acq *acq, float frange = RADE_ACQ_FRANGE)
+{
+    rade_acq_init(acq, &ofdm, frange, RADE_ACQ_FSTEP);
+}
+
+// Received buffer with pilots at tdelay and tdelay + Nmf, offset foff Hz
+static void make_rx(std::vector<RADE_COMP> &rx, int tdelay, float foff, float noise_amp)
+{
+    for (size_t n = 0; n < rx.size(); n++) {
+        rx[n] = noise(noise_amp);
+    }
+    for (int s = 0; s < 2; s++) {
+        for (int n = 0; n < RADE_M; n++) {
+            int i = tdelay + s * RADE_NMF + n;
+            RADE_COMP w = rade_cexp(2.0f * M_PI * foff * i / RADE_FS);
+            rx[i] = rade_cadd(rx[i], rade_cmul(ofdm.p[n], w));
+        }
+    }
+}
+
+static bool test_fft(int nfft, int inverse)
+{
+    static rade_fft_cfg cfg;
+    if (rade_fft_init(&cfg, nfft, inverse) != 0) return false;
+
+    std::vector<RADE_COMP> x(nfft), y(nfft);
+    for (int n = 0; n < nfft; n++) x[n] = noise(1.0f);
+    rade_fft(&cfg, y.data(), x.data());
+
+    double max_err = 0.0;
+    for (int k = 0; k < nfft; k++) {
+        double re = 0.0, im = 0.0;
+        for (int n = 0; n < nfft; n++) {
+            double theta = (inverse ? 2.0 : -2.0) * M_PI * ((double)k * n) / nfft;
+            re += x[n].real * cos(theta) - x[n].imag * sin(theta);
+            im += x[n].real * sin(theta) + x[n].imag * cos(theta);
+        }
+        max_err = std::fmax(max_err, std::hypot(re - y[k].real, im - y[k].imag));
+    }
+    return max_err < 1E-4 * std::sqrt((double)nfft);
+}
+
+int main()
+{
+    std::printf("=== RADE DSP tests ===\n");
+    rade_ofdm_init(&ofdm, 3);
+
+    // ── FFT against direct DFT ──────────────────────────────────────────────
+    CHECK(test_fft(160, 0), "160 point forward FFT");
+    CHECK(test_fft(160, 1), "160 point inverse FFT");
+    CHECK(test_fft(RADE_ACQ_NFFT, 0), "acquisition length FFT");
+    CHECK(test_fft(12, 0), "radix 3 FFT");
+    {
+        static rade_fft_cfg cfg;
+        CHECK(rade_fft_init(&cfg, 7 * 32, 0) != 0, "unsupported length rejected");
+    }
+
+    // ── Split complex dot product kernels against rade_cdot ─────────────────
+    {
+        std::vector<RADE_COMP> a(RADE_M), b(RADE_M);
+        std::vector<float> a_re(RADE_M), a_im(RADE_M), b_re(RADE_M), b_im(RADE_M);
+        for (int n = 0; n < RADE_M; n++) {
+            a[n] = noise(1.0f);
+            b[n] = noise(1.0f);
+        }
+        rade_csplit(a_re.data(), a_im.data(), a.data(), RADE_M);
+        rade_csplit(b_re.data(), b_im.data(), b.data(), RADE_M);
+
+        bool same = true;
+        int archs[] = { RADE_ARCH_C, rade_dsp_arch() };
+        for (int arch : archs) {
+            // Odd lengths exercise the scalar tail of the vector kernels
+            for (int n : { RADE_M, 13, 3 }) {
+                RADE_COMP ref = rade_cdot(a.data(), b.data(), n);
+                RADE_COMP c = rade_cdot_split(a_re.data(), a_im.data(),
+                                              b_re.data(), b_im.data(), n, arch);
+                same = same && std::hypot(c.real - ref.real, c.imag - ref.imag) < 1E-4f;
+            }
+        }
+        std::printf("  (kernel arch %d)\n", rade_dsp_arch());
+        CHECK(same, "split dot product matches rade_cdot");
+    }
+
+    // ── Symmetric FIR kernels against a plain sum ──────────────────────────
+    {
+        std::vector<RADE_COMP> x(RADE_BPF_NTAP_MAX);
+        std::vector<float> h2(2 * RADE_BPF_NTAP_MAX);
+        for (auto &v : x) v = noise(1.0f);
+        bool same = true;
+        for (int ntap : { 1, 3, 17, 19, 33, 101, RADE_BPF_NTAP_MAX }) {
+            RADE_COMP ref = rade_czero();
+            for (int k = 0; k < ntap; k++) {
+                float h = 1.0f + std::min(k, ntap - 1 - k);
+                h2[2 * k] = h2[2 * k + 1] = h;
+                ref = rade_cadd(ref, rade_cscale(x[k], h));
+            }
+            for (int arch : { RADE_ARCH_C, rade_dsp_arch() }) {
+                RADE_COMP y = rade_fir_sym(x.data(), h2.data(), ntap, arch);
+                same = same && std::hypot(y.real - ref.real, y.imag - ref.imag) < 1E-5f * ntap * ntap;
+            }
+        }
+        CHECK(same, "symmetric FIR kernels match plain sum");
+    }
+
+    // ── NCO against exp(j*w*n) ──────────────────────────────────────────────
+    {
+        // An hour of modem frames, retuned every frame like the rx corrector
+        static rade_nco nco;
+        rade_nco_init(&nco, 0.0f);
+        std::vector<RADE_COMP> ph(RADE_NEOO);
+        double theta = 0.0, max_err = 0.0, max_mag_err = 0.0;
+        int nframes = 3600 * RADE_FS / RADE_NMF;
+        for (int f = 0; f < nframes; f++) {
+            double w = -2.0 * M_PI * (10.0 + 0.37 * (f % 7)) / RADE_FS;
+            rade_nco_set_freq(&nco, (float)w);
+            rade_nco_gen(&nco, ph.data(), RADE_NEOO);
+            if (f % 1000 == 0 || f == nframes - 1) {
+                for (int n = 0; n < RADE_NEOO; n++) {
+                    double t = theta + w * (n + 1);
+                    max_err = std::fmax(max_err, std::hypot(ph[n].real - std::cos(t), ph[n].imag - std::sin(t)));
+                }
+            }
+            theta = std::fmod(theta + w * RADE_NEOO, 2.0 * M_PI);
+            max_mag_err = std::fmax(max_mag_err, std::fabs(rade_cabs(nco.phase) - 1.0));
+        }
+        CHECK(max_mag_err < 1E-5, "NCO magnitude stays at 1");
+
+        // Phase error is the float rounding of w, not the rotation
+        CHECK(max_err < 0.02, "NCO phase follows exp(j*w*n) over an hour");
+
+        std::vector<RADE_COMP> x(100), y(100);
+        for (int n = 0; n < 100; n++) x[n] = rade_cmplx(1.0f, (float)n);
+        rade_nco_init(&nco, 0.3f);
+        rade_nco_mix(&nco, y.data(), x.data(), 100);
+        bool mixed = true;
+        for (int n = 0; n < 100; n++) {
+            RADE_COMP ref = rade_cmul(x[n], rade_cexp(0.3f * (n + 1)));
+            mixed = mixed && std::hypot(y[n].real - ref.real, y[n].imag - ref.imag) < 1E-3f * (1 + n);
+        }
+        CHECK(mixed, "NCO mix");
+    }
+
+    // ── FFT pilot acquisition against brute force search ────────────────────
+    {
+        static rade_acq acq_fft, acq_direct;
+        acq_init(&acq_fft);
+        acq_init(&acq_direct);
+        acq_direct.fft_en = 0;
+        CHECK(acq_fft.fft_en, "FFT correlator enabled for default grid");
+
+        std::vector<RADE_COMP> rx(2 * RADE_NMF + RADE_M + RADE_NCP);
+        struct { int tdelay; float foff; float noise_amp; } cases[] = {
+            { 100,   0.0f, 0.01f },
+            { 537,  22.5f, 0.05f },
+            { 959, -41.0f, 0.1f },
+            { 17,   13.7f, 0.2f },
+            { 400,   0.0f, 1.0f },  // pilots buried in noise
+        };
+
+        bool same = true;
+        for (auto &c : cases) {
+            make_rx(rx, c.tdelay, c.foff, c.noise_amp);
+            int tmax1, tmax2;
+            float fmax1, fmax2;
+            int cand1 = rade_acq_detect_pilots(&acq_fft, rx.data(), &tmax1, &fmax1);
+            int cand2 = rade_acq_detect_pilots(&acq_direct, rx.data(), &tmax2, &fmax2);
+            same = same && cand1 == cand2 && tmax1 == tmax2 && fmax1 == fmax2 &&
+                   std::fabs(acq_fft.Dthresh - acq_direct.Dthresh) < 1E-3f * acq_direct.Dthresh &&
+                   std::fabs(acq_fft.Dtmax12 - acq_direct.Dtmax12) < 1E-3f * acq_direct.Dtmax12;
+        }
+        CHECK(same, "FFT acquisition matches brute force tmax/fmax/Dthresh");
+
+        make_rx(rx, 537, 22.5f, 0.01f);
+        int tmax;
+        float fmax;
+        int cand = rade_acq_detect_pilots(&acq_fft, rx.data(), &tmax, &fmax);
+        CHECK(cand && tmax == 537 && fmax == 22.5f, "FFT acquisition finds pilot");
+    }
+
+    // ── Coarse to fine acquisition ──────────────────────────────────────────
+    {
+        static rade_acq acq_fft, acq_direct;
+        acq_init(&acq_fft);
+        acq_init(&acq_direct);
+        acq_direct.fft_en = 0;
+        CHECK(rade_acq_set_decim(&acq_fft, 4) == 0 && rade_acq_set_decim(&acq_direct, 4) == 0,
+              "decimation 4 accepted");
+        CHECK(rade_acq_set_decim(&acq_fft, 7) != 0, "decimation 7 rejected");
+
+        // Pilots between the decimated timing offsets are found by the refinement
+        std::vector<RADE_COMP> rx(2 * RADE_NMF + RADE_M + RADE_NCP);
+        bool found = true;
+        for (int tdelay : { 537, 2, 958 }) {
+            make_rx(rx, tdelay, -22.5f, 0.05f);
+            int tmax1, tmax2;
+            float fmax1, fmax2;
+            int cand1 = rade_acq_detect_pilots(&acq_fft, rx.data(), &tmax1, &fmax1);
+            int cand2 = rade_acq_detect_pilots(&acq_direct, rx.data(), &tmax2, &fmax2);
+            found = found && cand1 && tmax1 == tdelay && fmax1 == -22.5f &&
+                    cand2 && tmax2 == tdelay && fmax2 == -22.5f;
+        }
+        CHECK(found, "coarse to fine acquisition finds pilot");
+    }
+
+    // ── Budgeted acquisition against full search ────────────────────────────
+    {
+        static rade_acq acq_budget, acq_full;
+        acq_init(&acq_budget);
+        acq_init(&acq_full);
+        CHECK(rade_acq_set_budget(&acq_budget, 12) == 0, "acquisition budget accepted");
+
+        // Pilots every modem frame, as a RADE signal has
+        int nbuf = 2 * RADE_NMF + RADE_M + RADE_NCP;
+        std::vector<RADE_COMP> stream(nbuf + 4 * RADE_NMF);
+        for (auto &x : stream) x = noise(0.1f);
+        for (int i = 123; i + RADE_M <= (int)stream.size(); i += RADE_NMF) {
+            for (int n = 0; n < RADE_M; n++) {
+                RADE_COMP w = rade_cexp(2.0f * M_PI * 27.5f * (i + n) / RADE_FS);
+                stream[i + n] = rade_cadd(stream[i + n], rade_cmul(ofdm.p[n], w));
+            }
+        }
+
+        // 40 search frequencies, 12 per call: complete on the 4th call
+        int results = 0;
+        bool same = true;
+        for (int i = 0; i < 4; i++) {
+            const RADE_COMP *rx = &stream[i * RADE_NMF];
+            if (i) {
+                rade_acq_shift(&acq_budget, RADE_NMF);
+                rade_acq_shift(&acq_full, RADE_NMF);
+            }
+            int tmax1 = -1, tmax2;
+            float fmax1 = 0.0f, fmax2;
+            int cand1 = rade_acq_detect_pilots(&acq_budget, rx, &tmax1, &fmax1);
+            int cand2 = rade_acq_detect_pilots(&acq_full, rx, &tmax2, &fmax2);
+            if (tmax1 >= 0) {
+                results++;
+                same = same && cand1 == cand2 && tmax1 == tmax2 && fmax1 == fmax2;
+            }
+        }
+        CHECK(results == 1 && same, "budgeted acquisition matches full search");
+    }
+
+    // ── Budgeted acquisition from the candidate state ───────────────────────
+    {
+        static rade_model model;
+        static rade_rx_state rx;
+        rade_model_init(&model, nullptr, 1);
+        rade_rx_init(&rx, &model, 3, 1, 0);
+        rx.verbose = 0;
+        rade_acq_set_budget(&rx.acq, 12);
+
+        // Pilots until the receiver has a candidate, then only noise.  The
+        // generator is put back after, so the tests below see the same noise
+        unsigned int lcg_saved = lcg_state;
+        std::vector<RADE_COMP> stream(20 * RADE_NMF);
+        for (auto &x : stream) x = noise(0.1f);
+        for (int i = 123; i + RADE_M <= 10 * RADE_NMF; i += RADE_NMF) {
+            for (int n = 0; n < RADE_M; n++) {
+                RADE_COMP w = rade_cexp(2.0f * M_PI * 27.5f * (i + n) / RADE_FS);
+                stream[i + n] = rade_cadd(stream[i + n], rade_cmul(rx.ofdm.p[n], w));
+            }
+        }
+        std::vector<float> features(rade_rx_n_features_out(&rx)), eoo(rade_rx_n_eoo_bits(&rx));
+        size_t pos = 0;
+        while (rx.state != RADE_STATE_CANDIDATE && pos < 10 * RADE_NMF) {
+            int nin = rade_rx_nin(&rx);
+            rade_rx_process(&rx, features.data(), eoo.data(), &stream[pos]);
+            pos += nin;
+        }
+        CHECK(rx.state == RADE_STATE_CANDIDATE, "budgeted search finds a candidate");
+
+        // Once it has gone the receiver searches again.  The part of the
+        // grid swept before the search completes has no candidates, and the
+        // last complete grid's are not followed again
+        for (size_t i = pos; i < stream.size(); i++) stream[i] = noise(0.1f);
+        for (int f = 0; f < 3; f++) {
+            int nin = rade_rx_nin(&rx);
+            rade_rx_process(&rx, features.data(), eoo.data(), &stream[pos]);
+            pos += nin;
+        }
+        CHECK(rx.state == RADE_STATE_SEARCH && rx.acq.sweep_pos != 0 && rx.acq.n_cand == 0,
+              "partial budgeted search drops stale candidates");
+        rade_rx_close(&rx);
+        rade_model_release(&model);
+        lcg_state = lcg_saved;
+    }
+
+    // ── Sliding acquisition against full recompute ──────────────────────────
+    {
+        static rade_acq acq_slide, acq_full;
+        acq_init(&acq_slide);
+        acq_init(&acq_full);
+        acq_full.slide_en = 0;
+
+        // Long stream, searched through a window that slides one frame per call
+        int nbuf = 2 * RADE_NMF + RADE_M + RADE_NCP;
+        std::vector<RADE_COMP> stream(nbuf + 6 * RADE_NMF);
+        make_rx(stream, 3 * RADE_NMF + 211, -17.5f, 0.05f);
+
+        bool same = true;
+        for (int i = 0; i < 6; i++) {
+            const RADE_COMP *rx = &stream[i * RADE_NMF];
+            int tmax1, tmax2;
+            float fmax1, fmax2;
+            if (i) {
+                rade_acq_shift(&acq_slide, RADE_NMF);
+                rade_acq_shift(&acq_full, RADE_NMF);
+            }
+            int cand1 = rade_acq_detect_pilots(&acq_slide, rx, &tmax1, &fmax1);
+            int cand2 = rade_acq_detect_pilots(&acq_full, rx, &tmax2, &fmax2);
+            same = same && cand1 == cand2 && tmax1 == tmax2 && fmax1 == fmax2 &&
+                   acq_slide.Dthresh == acq_full.Dthresh &&
+                   std::memcmp(acq_slide.abs_Dt1, acq_full.abs_Dt1, sizeof(acq_full.abs_Dt1)) == 0;
+        }
+        CHECK(same, "sliding acquisition matches full recompute");
+
+        // Any other advance must not reuse the stale correlations
+        rade_acq_shift(&acq_slide, RADE_NMF + RADE_M);
+        CHECK(acq_slide.Dt2_age != RADE_NMF, "odd sized shift invalidates Dt2");
+    }
+
+    // ── Candidate verification ──────────────────────────────────────────────
+    {
+        static rade_acq acq;
+        acq_init(&acq);
+
+        std::vector<RADE_COMP> rx(2 * RADE_NMF + RADE_M + RADE_NCP);
+        std::vector<RADE_COMP> other(rx.size());
+        make_rx(rx, 400, 10.0f, 0.1f);
+        int tmax;
+        float fmax;
+        int cand = rade_acq_detect_pilots(&acq, rx.data(), &tmax, &fmax);
+
+        // A stronger signal elsewhere on the band doesn't move the candidate
+        make_rx(rx, 402, 10.0f, 0.1f);
+        make_rx(other, 100, -30.0f, 0.0f);
+        for (size_t n = 0; n < rx.size(); n++) {
+            rx[n] = rade_cadd(rx[n], rade_cscale(other[n], 2.0f));
+        }
+        int verified = rade_acq_verify_pilots(&acq, rx.data(), 400, RADE_NCP - 1, fmax, &tmax, &fmax);
+        CHECK(cand && verified && tmax == 402 && fmax == 10.0f, "verification stays on candidate");
+
+        for (auto &x : rx) x = noise(0.1f);
+        CHECK(!rade_acq_verify_pilots(&acq, rx.data(), 400, RADE_NCP - 1, fmax, &tmax, &fmax),
+              "verification fails once pilots are gone");
+    }
+
+    // ── Several candidates followed at once ─────────────────────────────────
+    {
+        static rade_acq acq;
+        acq_init(&acq);
+
+        // Two signals: the search reports both, strongest first
+        std::vector<RADE_COMP> rx(2 * RADE_NMF + RADE_M + RADE_NCP);
+        std::vector<RADE_COMP> other(rx.size());
+        make_rx(rx, 700, 20.0f, 0.1f);
+        make_rx(other, 200, -15.0f, 0.0f);
+        for (size_t n = 0; n < rx.size(); n++) {
+            rx[n] = rade_cadd(rx[n], rade_cscale(other[n], 0.7f));
+        }
+        int tmax;
+        float fmax;
+        int cand = rade_acq_detect_pilots(&acq, rx.data(), &tmax, &fmax);
+        CHECK(cand && acq.n_cand == 2 &&
+              acq.cand[0].t == tmax && acq.fcoarse_range[acq.cand[0].f_idx] == fmax &&
+              acq.cand[1].t == 200 &&
+              std::fabs(acq.fcoarse_range[acq.cand[1].f_idx] + 15.0f) <= RADE_ACQ_FSTEP,
+              "search reports both signals but not their sidelobes");
+
+        // The strongest fades, the other is still there
+        make_rx(rx, 200, -15.0f, 0.1f);
+        int tcentre[2] = { acq.cand[0].t, acq.cand[1].t };
+        float fcentre[2] = { fmax, acq.fcoarse_range[acq.cand[1].f_idx] };
+        int tmax_c[2], valid[2];
+        float fmax_c[2];
+        int nvalid = rade_acq_verify_candidates(&acq, rx.data(), 2, tcentre, fcentre,
+                                                RADE_NCP - 1, tmax_c, fmax_c, valid);
+        CHECK(nvalid == 1 && !valid[0] && valid[1] && tmax_c[1] == 200 && fmax_c[1] == -15.0f,
+              "candidate verification keeps the one still there");
+    }
+
+    // ── Wide frequency range on the fixed size grid ─────────────────────────
+    {
+        static rade_acq acq_fft, acq_direct;
+        acq_init(&acq_fft, 1000.0f);
+        acq_init(&acq_direct, 1000.0f);
+        acq_direct.fft_en = 0;
+        CHECK(acq_fft.n_fcoarse == RADE_ACQ_NFREQ && acq_fft.fcoarse_step == 25.0f &&
+              acq_fft.ffine_step == RADE_ACQ_FSTEP && acq_fft.fft_en,
+              "wide range keeps the grid size with a coarser step");
+
+        // Between grid columns, reported at the fine resolution
+        std::vector<RADE_COMP> rx(2 * RADE_NMF + RADE_M + RADE_NCP);
+        make_rx(rx, 537, 337.5f, 0.01f);
+        bool found = true;
+        for (rade_acq *acq : { &acq_fft, &acq_direct }) {
+            int tmax;
+            float fmax;
+            int cand = rade_acq_detect_pilots(acq, rx.data(), &tmax, &fmax);
+            found = found && cand && tmax == 537 && fmax == 337.5f;
+        }
+        CHECK(found, "wide search finds an off grid signal at fine resolution");
+
+        CHECK(rade_acq_set_frange(&acq_fft, 2000.0f) != 0 &&
+              rade_acq_set_frange(&acq_fft, RADE_ACQ_FRANGE) == 0 &&
+              acq_fft.fcoarse_step == RADE_ACQ_FSTEP,
+              "frequency range beyond the coarsest step rejected");
+
+        // Off the FFT bins the direct search takes a decimation the FFT
+        // correlator can't, so coming back onto them must drop it
+        std::vector<RADE_COMP> rx_decim(rx.size());
+        make_rx(rx_decim, 301, 12.5f, 0.01f);
+        int tmax;
+        float fmax;
+        CHECK(rade_acq_set_frange(&acq_fft, 101.0f) == 0 && !acq_fft.fft_en &&
+              rade_acq_set_decim(&acq_fft, 3) == 0 &&
+              rade_acq_set_frange(&acq_fft, RADE_ACQ_FRANGE) == 0 && acq_fft.fft_en &&
+              acq_fft.tdecim == 1 &&
+              rade_acq_detect_pilots(&acq_fft, rx_decim.data(), &tmax, &fmax) &&
+              tmax == 301 && fmax == 12.5f,
+              "decimation the FFT grid can't use reset with the range");
+    }
+
+    // ── Sync state tracking against the brute force refinement ──────────────
+    {
+        static rade_acq acq;
+        acq_init(&acq);
+
+        std::vector<RADE_COMP> rx(2 * RADE_NMF + RADE_M + RADE_NCP);
+        bool close = true;
+        for (float fdelta : { 0.37f, -0.81f, 0.05f }) {
+            make_rx(rx, 321, 12.5f + fdelta, 0.03f);
+            int tmax1 = 318, tmax2 = 318;
+            float fmax1 = 12.5f, fmax2 = 12.5f;
+            rade_acq_refine(&acq, rx.data(), &tmax1, &fmax1, 310, 326, 11.5f, 13.5f, 0.1f);
+            rade_acq_track(&acq, rx.data(), &tmax2, &fmax2, 310, 326, 1.0f);
+            close = close && tmax1 == 321 && tmax2 == 321 &&
+                    std::fabs(fmax1 - (12.5f + fdelta)) < 0.1f &&
+                    std::fabs(fmax2 - (12.5f + fdelta)) < 0.1f;
+        }
+        CHECK(close, "closed form tracker matches refinement");
+    }
+
+    // ── Sync state noise statistics ─────────────────────────────────────────
+    {
+        static rade_acq acq_a, acq_b, acq_other;
+        acq_init(&acq_a);
+        acq_init(&acq_b);
+        acq_init(&acq_other);
+
+        std::vector<RADE_COMP> rx(2 * RADE_NMF + RADE_M + RADE_NCP);
+        make_rx(rx, 250, 5.0f, 0.3f);
+        int tmax;
+        float fmax;
+        rade_acq_detect_pilots(&acq_a, rx.data(), &tmax, &fmax);
+        rade_acq_detect_pilots(&acq_b, rx.data(), &tmax, &fmax);
+        rade_acq_detect_pilots(&acq_other, rx.data(), &tmax, &fmax);
+
+        // acq_b shares the process with another receiver, acq_a runs alone
+        bool same = true;
+        for (int f = 0; f < 50; f++) {
+            make_rx(rx, 250, 5.0f, 0.1f + 0.01f * f);
+            int valid_a, valid_b, valid_other, eoo;
+            rade_acq_check_pilots(&acq_a, rx.data(), tmax, fmax, &valid_a, &eoo);
+            rade_acq_check_pilots(&acq_other, rx.data(), tmax, fmax, &valid_other, &eoo);
+            rade_acq_check_pilots(&acq_b, rx.data(), tmax, fmax, &valid_b, &eoo);
+            same = same && valid_a == valid_b && acq_a.Dthresh == acq_b.Dthresh;
+        }
+        CHECK(same, "receivers pick their noise rows independently");
+
+        double sum_abs_Dt1 = 0.0, sum_abs_Dt2 = 0.0;
+        for (int t = 0; t < RADE_NMF; t++) {
+            for (int f_idx = 0; f_idx < acq_a.n_fcoarse; f_idx++) {
+                sum_abs_Dt1 += acq_a.abs_Dt1[t][f_idx];
+                sum_abs_Dt2 += acq_a.abs_Dt2[t][f_idx];
+            }
+        }
+        CHECK(std::fabs(acq_a.sum_abs_Dt1 - sum_abs_Dt1) < 1E-4 * sum_abs_Dt1 &&
+              std::fabs(acq_a.sum_abs_Dt2 - sum_abs_Dt2) < 1E-4 * sum_abs_Dt2 &&
+              acq_a.sum_count == RADE_NMF * acq_a.n_fcoarse,
+              "running noise sums match the grid");
+    }
+
+    // ── Threaded acquisition against single thread ──────────────────────────
+    {
+        static rade_acq acq_1, acq_n;
+
+        std::vector<RADE_COMP> rx(2 * RADE_NMF + RADE_M + RADE_NCP);
+        make_rx(rx, 301, 7.5f, 0.2f);
+
+        bool same = true;
+        for (int fft_en = 0; fft_en < 2; fft_en++) {
+            for (int nthreads : { 2, 3, 4 }) {
+                acq_init(&acq_1);
+                acq_init(&acq_n);
+                acq_1.fft_en = acq_n.fft_en = acq_1.fft_en && fft_en;
+                if (rade_acq_set_threads(&acq_n, nthreads) != 0) {
+                    same = false;
+                    continue;
+                }
+
+                int tmax1, tmax2;
+                float fmax1, fmax2;
+                int cand1 = rade_acq_detect_pilots(&acq_1, rx.data(), &tmax1, &fmax1);
+                int cand2 = rade_acq_detect_pilots(&acq_n, rx.data(), &tmax2, &fmax2);
+                same = same && cand1 == cand2 && tmax1 == tmax2 && fmax1 == fmax2 &&
+                       acq_1.Dthresh == acq_n.Dthresh && acq_1.Dtmax12 == acq_n.Dtmax12 &&
+                       std::memcmp(acq_1.abs_Dt2, acq_n.abs_Dt2, sizeof(acq_1.abs_Dt2)) == 0;
+                rade_acq_close(&acq_1);
+                rade_acq_close(&acq_n);
+            }
+        }
+        CHECK(same, "threaded acquisition identical to single thread");
+        CHECK(rade_acq_set_threads(&acq_n, RADE_POOL_MAXTHREADS + 1) != 0,
+              "too many acquisition threads rejected");
+    }
+
+    // ── Search gate ─────────────────────────────────────────────────────────
+    {
+        static rade_gate gate;
+        rade_gate_init(&gate, &ofdm);
+
+        std::vector<RADE_COMP> rx(RADE_NMF);
+        for (auto &x : rx) x = noise(1.0f);
+        CHECK(rade_gate_process(&gate, rx.data(), RADE_NMF) &&
+              rade_gate_process(&gate, rx.data(), RADE_NMF), "disabled gate always searches");
+
+        // Noise only: searches thinned out, but never further apart than period
+        const int period = 5;
+        gate.period = period;
+        rade_gate_reset(&gate);
+        int searches = 0, gap = 0, max_gap = 0;
+        for (int f = 0; f < 200; f++) {
+            for (auto &x : rx) x = noise(1.0f);
+            if (rade_gate_process(&gate, rx.data(), RADE_NMF)) {
+                searches++;
+                gap = 0;
+            } else {
+                max_gap = std::max(max_gap, ++gap);
+            }
+        }
+        CHECK(max_gap < period && searches < 200 / 2, "gate thins out search on noise");
+
+        // RADE signal 2 dB below the noise in 3 kHz opens the gate every frame
+        std::vector<RADE_COMP> tx(RADE_NMF);
+        std::vector<float> z(RADE_NZMF * RADE_LATENT_DIM);
+        bool open = true;
+        for (int f = 0; f < 20; f++) {
+            for (auto &v : z) v = 2.0f * uniform();
+            rade_ofdm_mod_frame(&ofdm, tx.data(), z.data());
+            float S = 0.0f;
+            for (auto &x : tx) S += rade_cabs2(x);
+            S /= RADE_NMF;
+            // uniform() noise has variance 1/12 per rail; N in 3 kHz = 3/8 of the total
+            float N3k = (3.0f / 8.0f) * 2.0f / 12.0f;
+            float g = std::sqrt(N3k * std::pow(10.0f, -2.0f / 10.0f) / S);
+            for (int n = 0; n < RADE_NMF; n++) {
+                rx[n] = rade_cadd(rade_cscale(tx[n], g), noise(1.0f));
+            }
+            open = open && rade_gate_process(&gate, rx.data(), RADE_NMF);
+        }
+        CHECK(open, "gate opens on -2 dB RADE signal");
+
+        // A station off tuned beyond the default range would land in the
+        // reference bands, so the receiver's gate is off while searching it
+        static rade_model model;
+        static rade_rx_state rx_state;
+        rade_model_init(&model, nullptr, 1);
+        rade_rx_init(&rx_state, &model, 3, 1, 0);
+        rade_rx_set_search_gate(&rx_state, period);
+        bool narrow = rx_state.gate.period == period;
+        rade_rx_set_frange(&rx_state, 1000.0f);
+        bool wide = rx_state.gate.period <= 1;
+        rade_rx_set_frange(&rx_state, RADE_ACQ_FRANGE);
+        CHECK(narrow && wide && rx_state.gate.period == period,
+              "receiver gate off for a wide search range");
+        rade_rx_close(&rx_state);
+        rade_model_release(&model);
+        rade_gate_close(&gate);
+    }
+
+    // ── OFDM DFT/IDFT against the carrier matrices ──────────────────────────
+    {
+        static rade_ofdm ofdm_fft, ofdm_direct;
+        rade_ofdm_init(&ofdm_fft, 3);
+        rade_ofdm_init(&ofdm_direct, 3);
+        ofdm_direct.fft_en = 0;
+        CHECK(ofdm_fft.fft_en, "OFDM FFT enabled by default");
+
+        std::vector<RADE_COMP> x(RADE_M), X(RADE_NC);
+        for (int n = 0; n < RADE_M; n++) x[n] = noise(1.0f);
+        for (int c = 0; c < RADE_NC; c++) X[c] = noise(1.0f);
+
+        // Reference: the Wfwd/Winv matrix products in double
+        double dft_err = 0.0, idft_err = 0.0;
+        std::vector<RADE_COMP> X1(RADE_NC), x1(RADE_M);
+        for (rade_ofdm *ofdm : { &ofdm_fft, &ofdm_direct }) {
+            rade_ofdm_dft(ofdm, X1.data(), x.data());
+            rade_ofdm_idft(ofdm, x1.data(), X.data());
+            for (int c = 0; c < RADE_NC; c++) {
+                double re = 0.0, im = 0.0;
+                for (int n = 0; n < RADE_M; n++) {
+                    double theta = -2.0 * M_PI * (ofdm->k0 + c) * n / RADE_M;
+                    re += x[n].real * cos(theta) - x[n].imag * sin(theta);
+                    im += x[n].real * sin(theta) + x[n].imag * cos(theta);
+                }
+                dft_err = std::fmax(dft_err, std::hypot(re - X1[c].real, im - X1[c].imag));
+            }
+            for (int n = 0; n < RADE_M; n++) {
+                double re = 0.0, im = 0.0;
+                for (int c = 0; c < RADE_NC; c++) {
+                    double theta = 2.0 * M_PI * (ofdm->k0 + c) * n / RADE_M;
+                    re += (X[c].real * cos(theta) - X[c].imag * sin(theta)) / RADE_M;
+                    im += (X[c].real * sin(theta) + X[c].imag * cos(theta)) / RADE_M;
+                }
+                idft_err = std::fmax(idft_err, std::hypot(re - x1[n].real, im - x1[n].imag));
+            }
+        }
+        CHECK(dft_err < 1E-4 && idft_err < 1E-6, "OFDM FFT and direct DFT/IDFT match matrices");
+
+        // Carriers survive IDFT then DFT
+        rade_ofdm_idft(&ofdm_fft, x1.data(), X.data());
+        rade_ofdm_dft(&ofdm_fft, X1.data(), x1.data());
+        double rt_err = 0.0;
+        for (int c = 0; c < RADE_NC; c++) {
+            rt_err = std::fmax(rt_err, std::hypot(X1[c].real - X[c].real, X1[c].imag - X[c].imag));
+        }
+        CHECK(rt_err < 1E-5, "OFDM IDFT/DFT round trip");
+    }
+
+    // ── Batched frame demodulation against symbol at a time ─────────────────
+    {
+        static rade_ofdm ofdm_fft, ofdm_direct;
+        rade_ofdm_init(&ofdm_fft, 3);
+        rade_ofdm_init(&ofdm_direct, 3);
+        ofdm_direct.fft_en = 0;
+
+        // Modem frame plus the next pilot, through a phase and gain change
+        std::vector<float> z(RADE_NZMF * RADE_LATENT_DIM);
+        for (auto &v : z) v = uniform();
+        std::vector<RADE_COMP> rx(RADE_NMF + RADE_M + RADE_NCP);
+        rade_ofdm_mod_frame(&ofdm_fft, rx.data(), z.data());
+        for (int n = 0; n < RADE_M + RADE_NCP; n++) rx[RADE_NMF + n] = ofdm_fft.p_cp[n];
+        for (auto &v : rx) v = rade_cadd(rade_cmul(v, rade_cpolar(0.3f, 1.1f)), noise(0.01f));
+
+        // Reference: remove CP, DFT, then equalize with atan2f/cexp
+        int time_offset = -4;
+        RADE_COMP rx_sym[RADE_NS + 2][RADE_NC];
+        RADE_COMP time_buf[RADE_M];
+        for (int s = 0; s < RADE_NS + 2; s++) {
+            rade_ofdm_remove_cp(&ofdm_direct, time_buf, &rx[s * (RADE_M + RADE_NCP)], time_offset);
+            rade_ofdm_dft(&ofdm_direct, rx_sym[s], time_buf);
+        }
+        RADE_COMP est[2][RADE_NC];
+        rade_ofdm_est_pilots(&ofdm_direct, est[0], rx_sym[0], 1);
+        rade_ofdm_est_pilots(&ofdm_direct, est[1], rx_sym[RADE_NS + 1], 1);
+        float mag_sum = 0.0f;
+        for (int c = 0; c < RADE_NC; c++) {
+            mag_sum += rade_cabs2(est[0][c]) + rade_cabs2(est[1][c]);
+        }
+        float mag = (std::sqrt(mag_sum / (2.0f * RADE_NC)) + 1E-6f) *
+                    rade_cabs(ofdm_fft.P[0]) / ofdm_fft.pilot_gain;
+        std::vector<float> z_ref;
+        for (int s = 1; s <= RADE_NS; s++) {
+            float t = (float)s / (RADE_NS + 1);
+            for (int c = 0; c < RADE_NC; c++) {
+                float angle = rade_cangle(rade_clerp(est[0][c], est[1][c], t));
+                RADE_COMP y = rade_cscale(rade_cmul(rx_sym[s][c], rade_cexp(-angle)), 1.0f / mag);
+                z_ref.push_back(y.real);
+                z_ref.push_back(y.imag);
+            }
+        }
+
+        bool same = true;
+        for (rade_ofdm *ofdm : { &ofdm_fft, &ofdm_direct }) {
+            std::vector<float> z_hat(RADE_NZMF * RADE_LATENT_DIM);
+            float snr;
+            int n = rade_ofdm_demod_frame(ofdm, z_hat.data(), rx.data(), time_offset, 0, 1, &snr);
+            same = same && n == (int)z_ref.size();
+            for (int i = 0; i < n && same; i++) {
+                same = std::fabs(z_hat[i] - z_ref[i]) < 1E-4f;
+            }
+        }
+        CHECK(same, "batched demodulation matches symbol at a time");
+    }
+
+    // ── Block BPF against the sample at a time filter ──────────────────────
+    {
+        // Reference: shift register, h dot product, exp() mixers every sample
+        struct ref_bpf {
+            std::vector<float> h;
+            std::vector<RADE_COMP> mem;
+            double alpha, n = 0;
+            RADE_COMP process(RADE_COMP x) {
+                n += 1;
+                RADE_COMP ph = rade_cmplx((float)std::cos(alpha * n), (float)-std::sin(alpha * n));
+                mem.insert(mem.begin(), rade_cmul(x, ph));
+                mem.pop_back();
+                RADE_COMP y = rade_czero();
+                for (size_t k = 0; k < h.size(); k++) y = rade_cadd(y, rade_cscale(mem[k], h[k]));
+                return rade_cmul(y, rade_cconj(ph));
+            }
+        };
+
+        bool same = true, ols_default = true;
+        for (int ntap : { 51, RADE_BPF_NTAP, RADE_BPF_NTAP_MAX }) {
+            static rade_bpf bpf;
+            rade_bpf_init(&bpf, ntap, RADE_FS, 1500.0f, 1500.0f, RADE_FS);
+            if (ntap != RADE_BPF_NTAP) {
+                ols_default = ols_default && bpf.fft_en == (ntap == RADE_BPF_NTAP_MAX);
+            }
+            ref_bpf ref;
+            ref.h.assign(bpf.h, bpf.h + ntap);
+            ref.mem.assign(ntap, rade_czero());
+            ref.alpha = bpf.alpha;
+
+            // Odd block sizes, switching between direct and overlap-save
+            for (int n : { 960, 37, 1, 700, 1152, 5 }) {
+                std::vector<RADE_COMP> x(n), y(n);
+                for (auto &v : x) v = noise(1.0f);
+                rade_bpf_process(&bpf, y.data(), x.data(), n);
+                for (int i = 0; i < n; i++) {
+                    RADE_COMP r = ref.process(x[i]);
+                    same = same && std::hypot(y[i].real - r.real, y[i].imag - r.imag) < 1E-4f;
+                }
+                bpf.fft_en = !bpf.fft_en;
+            }
+        }
+        CHECK(ols_default, "overlap-save chosen for long filters");
+        CHECK(same, "direct and overlap-save BPF match sample at a time filter");
+    }
+
+    // ── Complex tap BPF against the mixers ─────────────────────────────────
+    {
+        // Conjugate symmetric kernel against a plain complex sum
+        std::vector<RADE_COMP> x(RADE_BPF_NTAP_MAX), g(RADE_BPF_NTAP_MAX);
+        std::vector<float> g2_re(2 * RADE_BPF_NTAP_MAX), g2_im(2 * RADE_BPF_NTAP_MAX);
+        for (auto &v : x) v = noise(1.0f);
+        bool kernel = true;
+        for (int ntap : { 1, 3, 17, 19, 33, 101, RADE_BPF_NTAP_MAX }) {
+            int c = (ntap - 1) / 2;
+            RADE_COMP ref = rade_czero();
+            for (int k = 0; k < ntap; k++) {
+                g[k] = (k == c) ? rade_cmplx(1.0f, 0.0f) : noise(1.0f);
+                if (k > c) g[k] = rade_cconj(g[ntap - 1 - k]);
+                g2_re[2 * k] = g2_re[2 * k + 1] = g[k].real;
+                g2_im[2 * k] = g2_im[2 * k + 1] = g[k].imag;
+                ref = rade_cadd(ref, rade_cmul(g[k], x[k]));
+            }
+            for (int arch : { RADE_ARCH_C, rade_dsp_arch() }) {
+                RADE_COMP y = rade_fir_csym(x.data(), g2_re.data(), g2_im.data(), ntap, arch);
+                kernel = kernel && std::hypot(y.real - ref.real, y.imag - ref.imag) < 1E-4f * ntap;
+            }
+        }
+        CHECK(kernel, "conjugate symmetric FIR kernels match plain sum");
+
+        // The Tx BPF and the Rx BPF, default and widened for a 500 Hz search
+        float w_min = ofdm.w[0], w_max = ofdm.w[RADE_NC - 1];
+        float bandwidth = 1.2f * (w_max - w_min) * RADE_FS / (2.0f * M_PI);
+        float centre = (w_max + w_min) * RADE_FS / (2.0f * M_PI) / 2.0f;
+
+        bool same = true;
+        for (float extra : { 0.0f, 500.0f - RADE_ACQ_FRANGE }) {
+            for (int ntap : { RADE_BPF_NTAP, RADE_BPF_NTAP_MAX }) {
+                static rade_bpf mix, cplx;
+                rade_bpf_init(&mix, ntap, RADE_FS, bandwidth + extra, centre, RADE_FS);
+                rade_bpf_init(&cplx, ntap, RADE_FS, bandwidth + extra, centre, RADE_FS);
+                mix.cplx_en = 0;
+                cplx.cplx_en = 1;
+
+                // Either FIR engine under each, swapped between blocks
+                for (int n : { 960, 37, 1, 700, 1152, 5 }) {
+                    std::vector<RADE_COMP> xb(n), y_mix(n), y_cplx(n);
+                    for (auto &v : xb) v = noise(1.0f);
+                    rade_bpf_process(&mix, y_mix.data(), xb.data(), n);
+                    rade_bpf_process(&cplx, y_cplx.data(), xb.data(), n);
+                    for (int i = 0; i < n; i++) {
+                        same = same && std::hypot(y_cplx[i].real - y_mix[i].real,
+                                                  y_cplx[i].imag - y_mix[i].imag) < 1E-4f;
+                    }
+                    mix.fft_en = !mix.fft_en;
+                    cplx.fft_en = !mix.fft_en;
+                }
+            }
+        }
+        CHECK(same, "complex tap BPF matches mix, filter, mix for Tx and Rx");
+    }
+
+    // ── NN kernels picked at rade_open() against generic C ─────────────────
+    {
+        rade_initialize();
+        struct rade *r_cpu = rade_open(nullptr, RADE_VERBOSE_0);
+        struct rade *r_c = rade_open(nullptr, RADE_VERBOSE_0);
+        int arch = rade_nn_arch(r_cpu);
+        std::printf("  (NN arch %d)\n", arch);
+        CHECK(arch >= 0 && rade_set_nn_arch(r_c, arch + 1) == -1 && rade_set_nn_arch(r_c, -1) == -1 &&
+              rade_set_nn_arch(r_c, 0) == 0 && rade_nn_arch(r_c) == 0, "NN arch can be forced down only");
+
+        // Kernels differ only in rounding and activation approximations
+        std::vector<RADE_COMP> tx_cpu, tx_c;
+        tx_frames(r_cpu, 4, tx_cpu);
+        tx_frames(r_c, 4, tx_c);
+        CHECK(tx_err(tx_cpu, tx_c) <= 1E-4, "encoder output with CPU NN kernels matches generic C");
+        rade_close(r_cpu);
+        rade_close(r_c);
+        rade_finalize();
+    }
+
+    // ── Batched decoder kernels and rade_rx_batch() ────────────────────────
+    {
+        // Dense and block sparse products against a plain sum per vector
+        const int rows = 40, cols = 37, nb = 5;
+        std::vector<float> W(rows * cols), x(nb * (cols + 3)), y(nb * (rows + 1));
+        std::vector<int> idx;
+        std::vector<float> w_sp;
+        for (auto &v : W) v = uniform() - 0.5f;
+        for (auto &v : x) v = uniform() - 0.5f;
+        for (int i = 0; i < rows; i += 8) {
+            int nblk = (i / 8) % 3;
+            idx.push_back(nblk);
+            for (int k = 0; k < nblk; k++) {
+                idx.push_back(4 * k + (i / 8) % 2);
+                for (int m = 0; m < 32; m++) w_sp.push_back(uniform() - 0.5f);
+            }
+        }
+        bool gemm = true;
+        for (int arch : { RADE_ARCH_C, rade_dsp_arch() }) {
+            rade_sgemm_cm(y.data(), rows + 1, W.data(), rows, cols, x.data(), cols + 3, nb, arch);
+            for (int b = 0; b < nb; b++) {
+                for (int i = 0; i < rows; i++) {
+                    float ref = 0.0f;
+                    for (int j = 0; j < cols; j++) ref += W[j * rows + i] * x[b * (cols + 3) + j];
+                    gemm = gemm && std::fabs(y[b * (rows + 1) + i] - ref) < 1E-4f;
+                }
+            }
+            rade_sparse_sgemm8x4(y.data(), rows + 1, w_sp.data(), idx.data(), rows, x.data(), cols + 3, nb, arch);
+            for (int b = 0; b < nb; b++) {
+                const int *ip = idx.data();
+                const float *wp = w_sp.data();
+                for (int i = 0; i < rows; i += 8) {
+                    float ref[8] = { 0 };
+                    int nblk = *ip++;
+                    for (int k = 0; k < nblk; k++) {
+                        int pos = *ip++;
+                        for (int m = 0; m < 4; m++) {
+                            for (int r = 0; r < 8; r++) ref[r] += *wp++ * x[b * (cols + 3) + pos + m];
+                        }
+                    }
+                    for (int r = 0; r < 8; r++) {
+                        gemm = gemm && std::fabs(y[b * (rows + 1) + i + r] - ref[r]) < 1E-4f;
+                    }
+                }
+            }
+        }
+        CHECK(gemm, "batched dense and sparse products match plain sums");
+
+        // One transmission, each receiver seeing it with its own delay and
+        // noise, through rade_rx() and, for a twin receiver, rade_rx_batch()
+        rade_initialize();
+        const int nrx = 10;
+        struct rade *tx = rade_open(nullptr, RADE_VERBOSE_0);
+        int nf = rade_n_features_in_out(tx);
+        std::vector<float> features(nf);
+        std::vector<RADE_COMP> sig, frame(rade_n_tx_out(tx)), eoo(rade_n_tx_eoo_out(tx));
+        for (int f = 0; f < 30; f++) {
+            for (int i = 0; i < nf; i++) features[i] = 0.5f * std::sin(0.1f * i + f);
+            rade_tx(tx, frame.data(), features.data());
+            sig.insert(sig.end(), frame.begin(), frame.end());
+        }
+        rade_tx_eoo(tx, eoo.data());
+        sig.insert(sig.end(), eoo.begin(), eoo.end());
+        sig.insert(sig.end(), 4 * frame.size(), rade_czero());
+        rade_close(tx);
+
+        struct rade *r_one[nrx], *r_batch[nrx];
+        std::vector<std::vector<RADE_COMP>> rx_sig(nrx);
+        for (int k = 0; k < nrx; k++) {
+            r_one[k] = rade_open(nullptr, RADE_VERBOSE_0);
+            r_batch[k] = rade_open(nullptr, RADE_VERBOSE_0);
+            if (k == 3) {
+                // Its own NN kernels, so decoded outside the batch
+                rade_set_nn_arch(r_one[k], 0);
+                rade_set_nn_arch(r_batch[k], 0);
+            }
+            rx_sig[k].assign(137 * k, rade_czero());
+            rx_sig[k].insert(rx_sig[k].end(), sig.begin(), sig.end());
+            for (auto &v : rx_sig[k]) v = rade_cadd(v, noise(0.05f));
+        }
+
+        // The EOO demod fills the first (Ns-2)*Nc*2 of the rade_n_eoo_bits() floats
+        int nfo = rade_n_features_in_out(r_one[0]), neoo = rade_n_eoo_bits(r_one[0]);
+        int neoo_rx = (RADE_NS - 2) * RADE_NC * 2;
+        std::vector<std::vector<float>> f_one(nrx, std::vector<float>(nfo)), f_batch(nrx, std::vector<float>(nfo));
+        std::vector<std::vector<float>> e_one(nrx, std::vector<float>(neoo)), e_batch(nrx, std::vector<float>(neoo));
+        std::vector<size_t> pos(nrx, 0);
+        bool same = true;
+        int n_valid = 0, n_eoo = 0;
+        while (true) {
+            bool done = false;
+            for (int k = 0; k < nrx; k++) done = done || pos[k] + rade_nin_max(r_one[k]) > rx_sig[k].size();
+            if (done) break;
+
+            float *fb[nrx], *eb[nrx];
+            RADE_COMP *in[nrx];
+            int has_eoo_batch[nrx], n_out_batch[nrx];
+            for (int k = 0; k < nrx; k++) {
+                fb[k] = f_batch[k].data();
+                eb[k] = e_batch[k].data();
+                in[k] = &rx_sig[k][pos[k]];
+            }
+            rade_rx_batch(r_batch, nrx, fb, has_eoo_batch, eb, in, n_out_batch);
+
+            for (int k = 0; k < nrx; k++) {
+                int has_eoo;
+                int nin = rade_nin(r_one[k]);
+                int n_out = rade_rx(r_one[k], f_one[k].data(), &has_eoo, e_one[k].data(), in[k]);
+                same = same && n_out == n_out_batch[k] && has_eoo == has_eoo_batch[k] &&
+                       rade_sync(r_one[k]) == rade_sync(r_batch[k]) && rade_nin(r_one[k]) == rade_nin(r_batch[k]);
+                for (int i = 0; i < n_out; i++) same = same && std::fabs(f_one[k][i] - f_batch[k][i]) < 1E-3f;
+                for (int i = 0; has_eoo && i < neoo_rx; i++) same = same && e_one[k][i] == e_batch[k][i];
+                n_valid += n_out > 0;
+                n_eoo += has_eoo;
+                pos[k] += nin;
+            }
+        }
+        std::printf("  (%d valid frames, %d EOO)\n", n_valid, n_eoo);
+        CHECK(same && n_valid > 0 && n_eoo > 0, "rade_rx_batch() matches rade_rx() per receiver");
+        for (int k = 0; k < nrx; k++) {
+            rade_close(r_one[k]);
+            rade_close(r_batch[k]);
+        }
+        rade_finalize();
+    }
+
+    // ── int8 NN weights against float ──────────────────────────────────────
+    {
+        rade_initialize();
+        struct rade *r_f = rade_open(nullptr, RADE_VERBOSE_0);
+        struct rade *r_q = rade_open(nullptr, RADE_VERBOSE_0);
+        int int8_only = rade_nn_int8(r_f);   // RADE_INT8_WEIGHTS build
+        CHECK(rade_set_nn_int8(r_q, 1) == 0 && rade_nn_int8(r_q) == 1 &&
+              (rade_set_nn_int8(r_f, 0) == 0) == !int8_only && rade_nn_int8(r_f) == int8_only,
+              "int8 NN weights switch on, and off when float weights are built in");
+
+        // Quantisation noise only, well below the signal
+        std::vector<RADE_COMP> tx_f, tx_q;
+        tx_frames(r_f, 4, tx_f);
+        tx_frames(r_q, 4, tx_q);
+        CHECK(tx_err(tx_q, tx_f) <= 1E-2, "encoder output with int8 weights within 20 dB of float");
+        rade_close(r_f);
+        rade_close(r_q);
+        rade_finalize();
+    }
+
+    // ── Weight files against the built-in weights ──────────────────────────
+    {
+        const char *path = "test_rade_weights.bin";
+        const WeightArray *lists[] = { radeenc_arrays, radedec_arrays };
+        long len = rade_weights_write(path, lists, 2, 0);
+
+        // Every array indexed in place, 64 byte aligned, same contents
+        static rade_weights w;
+        bool same = len > 0 && rade_weights_open(&w, path) == 0 && (long)w.len == len;
+        int n = 0;
+        for (const WeightArray *const *l = lists; same && l < lists + 2; l++) {
+            for (const WeightArray *a = *l; same && a->name != NULL; a++, n++) {
+                const WeightArray *b = &w.arrays[n];
+                same = b->name != NULL && std::strcmp(a->name, b->name) == 0 && a->type == b->type &&
+                       a->size == b->size && std::memcmp(a->data, b->data, a->size) == 0 &&
+                       (const char *)b->data > (const char *)w.blob &&
+                       (const char *)b->data < (const char *)w.blob + w.len &&
+                       ((const char *)b->data - (const char *)w.blob) % WEIGHT_BLOCK_SIZE == 0;
+            }
+        }
+        same = same && w.arrays[n].name == NULL;
+        rade_weights_close(&w);
+        CHECK(same, "weight file maps every built-in array in place");
+
+        // Same Tx from the file, and the built-in weights for anything else
+        rade_initialize();
+        struct rade *r_b = rade_open(nullptr, RADE_VERBOSE_0);
+        struct rade *r_f = rade_open((char *)path, RADE_VERBOSE_0);
+        char bad_path[] = "no_such_model.pth";
+        struct rade *r_x = rade_open(bad_path, RADE_VERBOSE_0);
+        std::vector<RADE_COMP> tx_b, tx_f, tx_x;
+        if (r_f != nullptr && r_x != nullptr) {
+            tx_frames(r_b, 4, tx_b);
+            tx_frames(r_f, 4, tx_f);
+            tx_frames(r_x, 4, tx_x);
+        }
+        CHECK(!tx_b.empty() && tx_same(tx_f, tx_b) && tx_same(tx_x, tx_b),
+              "rade_open() on a weight file matches built-in weights");
+        rade_close(r_b);
+        rade_close(r_f);
+        rade_close(r_x);
+        rade_finalize();
+        std::remove(path);
+    }
+
+    // ── Contexts sharing one model ─────────────────────────────────────────
+    {
+        rade_initialize();
+        struct rade_model *m = rade_model_open(nullptr);
+        struct rade *r_own = rade_open(nullptr, RADE_VERBOSE_0);
+        struct rade *r_a = rade_open_model(m, RADE_VERBOSE_0);
+        struct rade *r_b = rade_open_model(m, RADE_VERBOSE_0);
+        struct rade *r_q = rade_open_model(m, RADE_VERBOSE_0);
+
+        // int8 is per context, the model is not changed by it
+        int int8_ok = rade_set_nn_int8(r_q, 1) == 0;
+        CHECK(m != nullptr && int8_ok && rade_nn_int8(r_q) == 1 && rade_nn_int8(r_a) == rade_nn_int8(r_own),
+              "contexts on one model switch int8 on their own");
+
+        std::vector<RADE_COMP> tx_own, tx_a, tx_b;
+        tx_frames(r_own, 4, tx_own);
+        tx_frames(r_a, 4, tx_a);
+        tx_frames(r_b, 4, tx_b);
+        CHECK(tx_same(tx_a, tx_own) && tx_same(tx_b, tx_own), "contexts on a shared model match rade_open()");
+        CHECK(rade_version() >= 3, "API version has shared models");
+        rade_close(r_own);
+        rade_close(r_a);
+        rade_close(r_b);
+        rade_close(r_q);
+        rade_model_close(m);
+        rade_finalize();
+    }
+
+    std::printf("\n%d / %d tests passed\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
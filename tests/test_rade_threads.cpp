@@ -0,0 +1,154 @@
+/**
+ * test_rade_threads.cpp
+ *
+ * Runs many RADE contexts at once, one per thread, and checks that each
+ * gives exactly what it gives when run alone: the library must have no
+ * global or static state that contexts could share.
+ *
+ * Run directly:  ./test_rade_threads
+ * Run via CTest: ctest --test-dir build -R rade_threads
+ */
+
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "radae/rade_api.h"
+#include "radae/rade_dsp.h"
+
+#include "test_rade_tx.h"
+
+static int tests_run    = 0;
+static int tests_passed = 0;
+
+#define CHECK(expr, label)                                              \
+    do {                                                                \
+        ++tests_run;                                                    \
+        if (expr) {                                                     \
+            ++tests_passed;                                             \
+            std::printf("  PASS  %s\n", label);                        \
+        } else {                                                        \
+            std::printf("  FAIL  %s\n", label);                        \
+        }                                                               \
+    } while (0)
+
+static constexpr int NCONTEXTS = 8;
+static constexpr int NFRAMES   = 30;   // Modem frames transmitted per job
+
+// Everything a context puts out in one job, compared bit for bit
+struct Output {
+    std::vector<RADE_COMP> tx;
+    std::vector<float> features;
+    std::vector<float> eoo;
+    std::vector<int> flags;             // n_out, has_eoo and sync per frame
+
+    bool operator==(const Output &o) const {
+        return tx_same(tx, o.tx) && features == o.features && eoo == o.eoo && flags == o.flags;
+    }
+};
+
+// Each job has its own generator state, so it draws the same noise on any
+// thread
+static float uniform(unsigned int &state)
+{
+    state = state * 1103515245u + 12345u;
+    return ((state >> 8) & 0xffff) / 65536.0f - 0.5f;
+}
+
+// Context k transmits, then receives that signal delayed and with noise of
+// its own.  Some contexts share a model, some search with worker threads,
+// one decodes on int8 weights
+static void job(int k, struct rade_model *model, Output &out)
+{
+    struct rade *r = (k % 2) ? rade_open_model(model, RADE_VERBOSE_0) : rade_open(nullptr, RADE_VERBOSE_0);
+    if (r == nullptr) {
+        return;
+    }
+    if (k % 4 == 1) {
+        rade_set_acq_threads(r, 2);
+    }
+    if (k == 2) {
+        rade_set_nn_int8(r, 1);
+    }
+
+    std::vector<RADE_COMP> eoo(rade_n_tx_eoo_out(r));
+    tx_frames(r, NFRAMES, out.tx);
+    rade_tx_eoo(r, eoo.data());
+    out.tx.insert(out.tx.end(), eoo.begin(), eoo.end());
+
+    unsigned int state = 1 + k;
+    std::vector<RADE_COMP> rx(97 * k + out.tx.size() + 4 * rade_n_tx_out(r), RADE_COMP{ 0.0f, 0.0f });
+    for (size_t i = 0; i < rx.size(); i++) {
+        if (i >= (size_t)(97 * k) && i - 97 * k < out.tx.size()) {
+            rx[i] = out.tx[i - 97 * k];
+        }
+        rx[i].real += 0.05f * uniform(state);
+        rx[i].imag += 0.05f * uniform(state);
+    }
+
+    // The EOO demod fills the first (Ns-2)*Nc*2 of the rade_n_eoo_bits()
+    // floats, rade_rx() leaves the rest as is
+    std::vector<float> features_out(rade_n_features_in_out(r)), eoo_out(rade_n_eoo_bits(r));
+    int neoo_rx = (RADE_NS - 2) * RADE_NC * 2;
+    size_t pos = 0;
+    while (pos + rade_nin_max(r) <= rx.size()) {
+        int nin = rade_nin(r);
+        int has_eoo = 0;
+        int n_out = rade_rx(r, features_out.data(), &has_eoo, eoo_out.data(), &rx[pos]);
+        pos += nin;
+        out.features.insert(out.features.end(), features_out.begin(), features_out.begin() + n_out);
+        if (has_eoo) {
+            out.eoo.insert(out.eoo.end(), eoo_out.begin(), eoo_out.begin() + neoo_rx);
+        }
+        out.flags.push_back(n_out);
+        out.flags.push_back(has_eoo);
+        out.flags.push_back(rade_sync(r));
+    }
+    rade_close(r);
+}
+
+int main()
+{
+    std::printf("test_rade_threads\n");
+    rade_initialize();
+    struct rade_model *model = rade_model_open(nullptr);
+    CHECK(model != nullptr, "shared model opens");
+
+    // One context at a time on this thread
+    std::vector<Output> ref(NCONTEXTS);
+    for (int k = 0; k < NCONTEXTS; k++) {
+        job(k, model, ref[k]);
+    }
+    int n_valid = 0;
+    for (const Output &o : ref) {
+        for (size_t i = 0; i < o.flags.size(); i += 3) {
+            n_valid += o.flags[i] > 0;
+        }
+    }
+    std::printf("  (%d frames decoded over %d contexts)\n", n_valid, NCONTEXTS);
+    CHECK(n_valid > 0, "contexts decode their signals");
+
+    // All of them at once, a few times over
+    bool same = true;
+    for (int round = 0; round < 3; round++) {
+        std::vector<Output> out(NCONTEXTS);
+        std::vector<std::thread> threads;
+        for (int k = 0; k < NCONTEXTS; k++) {
+            threads.emplace_back(job, k, model, std::ref(out[k]));
+        }
+        for (std::thread &t : threads) {
+            t.join();
+        }
+        for (int k = 0; k < NCONTEXTS; k++) {
+            same = same && out[k] == ref[k];
+        }
+    }
+    CHECK(same, "contexts on their own threads match single threaded runs");
+
+    rade_model_close(model);
+    rade_finalize();
+
+    std::printf("\n%d / %d tests passed\n", tests_passed, tests_run);
+    return (tests_passed == tests_run) ? 0 : 1;
+}
@@ -0,0 +1,48 @@
+/**
+ * test_rade_tx.h
+ *
+ * Tx signals shared by the RADE tests that compare contexts.
+ */
+
+#ifndef TEST_RADE_TX_H
+#define TEST_RADE_TX_H
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "radae/rade_api.h"
+
+// nframes modem frames of smooth test features through r's encoder,
+// replacing tx.  A few frames bring in the encoder's GRU state
+static inline void tx_frames(struct rade *r, int nframes, std::vector<RADE_COMP> &tx)
+{
+    int nf = rade_n_features_in_out(r);
+    std::vector<float> features(nf);
+    std::vector<RADE_COMP> frame(rade_n_tx_out(r));
+    tx.clear();
+    for (int f = 0; f < nframes; f++) {
+        for (int i = 0; i < nf; i++) features[i] = 0.5f * std::sin(0.1f * i + f);
+        rade_tx(r, frame.data(), features.data());
+        tx.insert(tx.end(), frame.begin(), frame.end());
+    }
+}
+
+// Energy of a - b relative to the energy of b
+static inline double tx_err(const std::vector<RADE_COMP> &a, const std::vector<RADE_COMP> &b)
+{
+    double err = 0.0, power = 0.0;
+    for (size_t i = 0; i < a.size() && i < b.size(); i++) {
+        err += std::pow(a[i].real - b[i].real, 2) + std::pow(a[i].imag - b[i].imag, 2);
+        power += std::pow(b[i].real, 2) + std::pow(b[i].imag, 2);
+    }
+    return (a.size() == b.size() && power > 0.0) ? err / power : 1.0;
+}
+
+// Bit for bit the same samples
+static inline bool tx_same(const std::vector<RADE_COMP> &a, const std::vector<RADE_COMP> &b)
+{
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), sizeof(RADE_COMP) * a.size()) == 0;
+}
+
+#endif